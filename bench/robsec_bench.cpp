@@ -0,0 +1,407 @@
+/// @file robsec_bench.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Micro and macro benchmarks of the game components.
+
+#include "robsec/board.hpp"
+#include "robsec/dictionary.hpp"
+#include "robsec/dictionary_cache.hpp"
+#include "robsec/free_space.hpp"
+#include "robsec/game.hpp"
+#include "robsec/likeness.hpp"
+#include "robsec/snapshot.hpp"
+#include "robsec/solver.hpp"
+
+#include <benchmark/benchmark.h>
+#include <curses.h>
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+/// @brief Number of words in the huge generated dictionary.
+#define HUGE_DICTIONARY_WORDS 1000000
+
+/// @brief Returns the path of the dictionary shipped with the repository.
+static std::string small_dictionary_path()
+{
+    return ROBSEC_DATA_DIR "/words.txt";
+}
+
+/// @brief Returns the path of a huge text dictionary, generating it the first time.
+static std::string huge_dictionary_path()
+{
+    static const std::string path = ROBSEC_BENCH_DIR "/huge_words.txt";
+    static bool generated         = false;
+    if (!generated) {
+        std::ofstream file(path);
+        robsec::RandomEngine engine(1);
+        std::uniform_int_distribution<int> letter('a', 'z'), length(3, 14);
+        std::string word;
+        for (std::size_t i = 0; i < HUGE_DICTIONARY_WORDS; ++i) {
+            word.resize(static_cast<std::size_t>(length(engine)));
+            for (auto &c : word) {
+                c = static_cast<char>(letter(engine));
+            }
+            file << word << "\n";
+        }
+        generated = true;
+    }
+    return path;
+}
+
+/// @brief Returns the path of the huge dictionary, compiled, generating it the first time.
+static std::string huge_compiled_dictionary_path()
+{
+    static const std::string path = ROBSEC_BENCH_DIR "/huge_words.bin";
+    static bool generated         = false;
+    if (!generated) {
+        robsec::Dictionary dictionary;
+        dictionary.load(huge_dictionary_path());
+        dictionary.save(path);
+        generated = true;
+    }
+    return path;
+}
+
+/// @brief Returns the dictionary shipped with the repository, loaded once.
+static const robsec::Dictionary &small_dictionary()
+{
+    static robsec::Dictionary dictionary;
+    if (dictionary.get_size() == 0) {
+        dictionary.load(small_dictionary_path());
+    }
+    return dictionary;
+}
+
+/// @brief Generates a board with the layout given by the arguments of the benchmark.
+static bool generate_board(benchmark::State &state, robsec::Board &board, robsec::RandomEngine &engine)
+{
+    robsec::BoardGenerator generator(
+        small_dictionary(),
+        static_cast<std::size_t>(state.range(0)),
+        static_cast<std::size_t>(state.range(1)),
+        static_cast<std::size_t>(state.range(2)),
+        static_cast<std::size_t>(state.range(3)));
+    return generator.generate(board, engine);
+}
+
+/// @brief The layouts used by the board benchmarks: panels, rows, columns, words.
+static void board_layouts(benchmark::internal::Benchmark *benchmark)
+{
+    benchmark->ArgNames({ "panels", "rows", "columns", "words" });
+    benchmark->Args({ 3, 20, 12, 12 });
+    benchmark->Args({ 4, 15, 15, 15 });
+    benchmark->Args({ 3, 20, 12, 30 });
+    benchmark->Args({ 2, 10, 12, 20 });
+    benchmark->Args({ 8, 40, 24, 100 });
+}
+
+// ============================================================================
+// Dictionary.
+
+static void BM_LoadDictionarySmall(benchmark::State &state)
+{
+    const std::string path = small_dictionary_path();
+    for (auto _ : state) {
+        robsec::Dictionary dictionary;
+        benchmark::DoNotOptimize(dictionary.load(path));
+    }
+}
+BENCHMARK(BM_LoadDictionarySmall);
+
+static void BM_LoadDictionaryHuge(benchmark::State &state)
+{
+    const std::string path = huge_dictionary_path();
+    for (auto _ : state) {
+        robsec::Dictionary dictionary;
+        benchmark::DoNotOptimize(dictionary.load(path));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * HUGE_DICTIONARY_WORDS);
+}
+BENCHMARK(BM_LoadDictionaryHuge)->Unit(benchmark::kMillisecond);
+
+static void BM_LoadDictionaryHugeCompiled(benchmark::State &state)
+{
+    const std::string path = huge_compiled_dictionary_path();
+    for (auto _ : state) {
+        robsec::Dictionary dictionary;
+        benchmark::DoNotOptimize(dictionary.load(path));
+    }
+}
+BENCHMARK(BM_LoadDictionaryHugeCompiled);
+
+static void BM_AcquireDictionaryHuge(benchmark::State &state)
+{
+    // Keep a user alive, as a running game would, so that every acquire hits.
+    const std::string path = huge_dictionary_path();
+    std::shared_ptr<const robsec::Dictionary> shared = robsec::DictionaryCache::acquire(path);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(robsec::DictionaryCache::acquire(path));
+    }
+}
+BENCHMARK(BM_AcquireDictionaryHuge);
+
+// ============================================================================
+// Board generation.
+
+static void BM_GenerateBoard(benchmark::State &state)
+{
+    robsec::RandomEngine engine(1);
+    robsec::Board board;
+    for (auto _ : state) {
+        if (!generate_board(state, board, engine)) {
+            state.SkipWithError("Failed to generate the board.");
+            break;
+        }
+        benchmark::DoNotOptimize(board.word_ids.data());
+    }
+}
+BENCHMARK(BM_GenerateBoard)->Apply(board_layouts);
+
+static void BM_FindUnoccupiedSpace(benchmark::State &state)
+{
+    // Place words of 7 letters, plus the separator, until the given density.
+    const std::size_t n_panels = static_cast<std::size_t>(state.range(0));
+    const std::size_t n_cells  = static_cast<std::size_t>(state.range(1) * state.range(2));
+    const std::size_t span     = 8;
+    const std::size_t n_words  = n_panels * ((n_cells + 1) / span) * static_cast<std::size_t>(state.range(3)) / 100;
+    robsec::RandomEngine engine(1);
+    robsec::Arena arena(16384);
+    robsec::FreeSpaceIndex free_space(arena);
+    std::size_t panel, start;
+    for (auto _ : state) {
+        free_space.reset(n_panels, n_cells + 1, span, n_words);
+        for (std::size_t remaining = n_words; remaining > 0; --remaining) {
+            benchmark::DoNotOptimize(free_space.occupy_random(engine, remaining, panel, start));
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n_words));
+}
+BENCHMARK(BM_FindUnoccupiedSpace)
+    ->ArgNames({ "panels", "rows", "columns", "density" })
+    ->Args({ 3, 20, 12, 25 })
+    ->Args({ 3, 20, 12, 50 })
+    ->Args({ 3, 20, 12, 75 })
+    ->Args({ 3, 20, 12, 100 })
+    ->Args({ 8, 40, 24, 100 });
+
+// ============================================================================
+// Likeness.
+
+static void BM_CountCommonLettersScalar(benchmark::State &state)
+{
+    const char *a = "TERMINAL", *b = "INDUSTRY";
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(robsec::count_common_letters(a, b));
+    }
+}
+BENCHMARK(BM_CountCommonLettersScalar);
+
+static void BM_CountCommonLettersHistogram(benchmark::State &state)
+{
+    robsec::LetterHistogram a("TERMINAL", 8), b("INDUSTRY", 8);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(robsec::count_common_letters(a, b));
+    }
+}
+BENCHMARK(BM_CountCommonLettersHistogram);
+
+static void BM_BuildLikenessMatrix(benchmark::State &state)
+{
+    robsec::RandomEngine engine(1);
+    robsec::Board board;
+    if (!generate_board(state, board, engine)) {
+        state.SkipWithError("Failed to generate the board.");
+        return;
+    }
+    robsec::LikenessMatrix matrix;
+    for (auto _ : state) {
+        matrix.build(*board.group, board.word_ids.data(), board.get_n_words());
+        benchmark::DoNotOptimize(matrix.row(0));
+    }
+}
+BENCHMARK(BM_BuildLikenessMatrix)->Apply(board_layouts);
+
+// ============================================================================
+// Snapshots.
+
+static void BM_SerializeBoard(benchmark::State &state)
+{
+    robsec::RandomEngine engine(1);
+    robsec::Board board;
+    if (!generate_board(state, board, engine)) {
+        state.SkipWithError("Failed to generate the board.");
+        return;
+    }
+    std::vector<char> buffer;
+    for (auto _ : state) {
+        buffer.clear();
+        robsec::serialize_board(small_dictionary(), board, buffer);
+        benchmark::DoNotOptimize(buffer.data());
+    }
+    state.counters["bytes"] = static_cast<double>(buffer.size());
+}
+BENCHMARK(BM_SerializeBoard)->Apply(board_layouts);
+
+static void BM_DeserializeBoard(benchmark::State &state)
+{
+    robsec::RandomEngine engine(1);
+    robsec::Board board;
+    if (!generate_board(state, board, engine)) {
+        state.SkipWithError("Failed to generate the board.");
+        return;
+    }
+    std::vector<char> buffer;
+    robsec::serialize_board(small_dictionary(), board, buffer);
+    for (auto _ : state) {
+        std::size_t offset = 0;
+        if (!robsec::deserialize_board(small_dictionary(), buffer.data(), buffer.size(), offset, board)) {
+            state.SkipWithError("Failed to deserialize the board.");
+            break;
+        }
+        benchmark::DoNotOptimize(board.word_ids.data());
+    }
+}
+BENCHMARK(BM_DeserializeBoard)->Apply(board_layouts);
+
+/// @brief Clicks the cell at the given linear position of a panel of the game.
+static void click_cell(robsec::Game &game, std::size_t panel, std::size_t position)
+{
+    const robsec::Board &board = game.get_board();
+    robsec::ScreenLocation location =
+        robsec::linear_to_screen_location(robsec::Layout<0, 0, 0>(board.n_panels, board.n_rows, board.n_columns), panel, position);
+    robsec::InputEvent event{ KEY_MOUSE, static_cast<int>(location.x), static_cast<int>(location.y) };
+    game.handle_input(&event, 1);
+}
+
+/// @brief Guesses the wrong words not guessed yet, until `n_guesses` were made or the round is over.
+static void guess_wrong_words(robsec::Game &game, std::size_t n_guesses)
+{
+    const robsec::Board &board = game.get_board();
+    for (std::size_t i = 0; (i < board.get_n_words()) && (n_guesses > 0) && !game.is_over(); ++i) {
+        bool guessed = (i == board.solution_index) || board.is_removed(i);
+        for (const robsec::Game::Feedback &guess : game.get_feedback()) {
+            guessed = guessed || (guess.word == i);
+        }
+        if (!guessed) {
+            click_cell(game, board.word_panels[i], board.word_starts[i]);
+            --n_guesses;
+        }
+    }
+}
+
+/// @brief Uses the bracket pairs of the board until one replenishes the attempts.
+static bool replenish_attempts(robsec::Game &game)
+{
+    const robsec::Board &board = game.get_board();
+    const std::size_t n_cells  = board.n_rows * board.n_columns;
+    for (std::size_t cell = 0; cell < board.pairs.size(); ++cell) {
+        if (board.pairs[cell] != 0) {
+            click_cell(game, cell / n_cells, cell % n_cells);
+            if (game.get_attempts() == game.get_attempts_max()) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/// @brief Saves and restores a lost round (0), or a round whose log scrolled after a refill (1).
+static void BM_SnapshotGame(benchmark::State &state)
+{
+    const robsec::ScreenLocation size = robsec::Game::get_screen_size(3, 20, 12, 4);
+    robsec::FrameBufferRenderTarget target(static_cast<int>(size.x), static_cast<int>(size.y));
+    robsec::FrameBufferRenderTarget restored_target(static_cast<int>(size.x), static_cast<int>(size.y));
+    std::unique_ptr<robsec::Game> game;
+    bool ready = false;
+    for (unsigned seed = 1; (seed < 100) && !ready; ++seed) {
+        game.reset(new robsec::Game(target, robsec::DictionaryCache::acquire(small_dictionary_path()), 3, 20, 12, 12, 4, seed, nullptr));
+        if (!game->initialize()) {
+            state.SkipWithError("Failed to initialize the game.");
+            return;
+        }
+        if (state.range(0) == 0) {
+            guess_wrong_words(*game, 4);
+            ready = game->is_over() && !game->has_won();
+        } else {
+            // Leave one attempt, replenish them, then guess past the rows of the log.
+            guess_wrong_words(*game, 3);
+            ready = replenish_attempts(*game);
+            guess_wrong_words(*game, 2);
+            ready = ready && (game->get_feedback().size() == 5);
+        }
+    }
+    if (!ready) {
+        state.SkipWithError("Failed to reach the round to save.");
+        return;
+    }
+    state.SetLabel((state.range(0) == 0) ? "lost" : "refilled");
+
+    // The restored round must save to the same bytes.
+    robsec::Game restored(restored_target, robsec::DictionaryCache::acquire(small_dictionary_path()), 3, 20, 12, 12, 4, 1, nullptr);
+    std::vector<char> saved, resaved;
+    if (!restored.initialize() || !game->serialize(saved)) {
+        state.SkipWithError("Failed to save the round.");
+        return;
+    }
+    for (auto _ : state) {
+        resaved.clear();
+        if (!restored.deserialize(saved.data(), saved.size()) || !restored.serialize(resaved) || (resaved != saved)) {
+            state.SkipWithError("Failed to restore the round.");
+            break;
+        }
+        target.clear_output();
+        restored_target.clear_output();
+    }
+    state.counters["bytes"] = static_cast<double>(saved.size());
+}
+BENCHMARK(BM_SnapshotGame)->ArgName("refilled")->DenseRange(0, 1);
+
+// ============================================================================
+// Solver.
+
+static void BM_SolverBestGuess(benchmark::State &state)
+{
+    robsec::RandomEngine engine(1);
+    robsec::Board board;
+    if (!generate_board(state, board, engine)) {
+        state.SkipWithError("Failed to generate the board.");
+        return;
+    }
+    robsec::Solver solver;
+    solver.reset(board.likeness);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(solver.best_guess());
+    }
+}
+BENCHMARK(BM_SolverBestGuess)->Apply(board_layouts);
+
+// ============================================================================
+// Rendering.
+
+static void BM_RenderFrame(benchmark::State &state)
+{
+    const std::size_t n_panels        = static_cast<std::size_t>(state.range(0));
+    const std::size_t n_rows          = static_cast<std::size_t>(state.range(1));
+    const std::size_t n_columns       = static_cast<std::size_t>(state.range(2));
+    const robsec::ScreenLocation size = robsec::Game::get_screen_size(n_panels, n_rows, n_columns, 4);
+    robsec::FrameBufferRenderTarget target(static_cast<int>(size.x), static_cast<int>(size.y));
+    robsec::Game game(target, robsec::DictionaryCache::acquire(small_dictionary_path()), n_panels, n_rows, n_columns,
+                      static_cast<std::size_t>(state.range(3)), 4, 1, nullptr);
+    if (!game.initialize()) {
+        state.SkipWithError("Failed to initialize the game.");
+        return;
+    }
+    // Sweep the cursor over the first panel, so that the selection changes.
+    const int keys[] = { KEY_RIGHT, KEY_RIGHT, KEY_RIGHT, KEY_DOWN, KEY_LEFT, KEY_LEFT, KEY_LEFT, KEY_UP };
+    std::size_t key  = 0;
+    for (auto _ : state) {
+        game.handle_key(keys[key++ % 8]);
+        benchmark::DoNotOptimize(target.get_output().data());
+        target.clear_output();
+    }
+}
+BENCHMARK(BM_RenderFrame)->Apply(board_layouts);
+
+BENCHMARK_MAIN();
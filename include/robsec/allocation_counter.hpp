@@ -0,0 +1,22 @@
+/// @file allocation_counter.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Process-wide counter of the heap allocations.
+
+#pragma once
+
+#include <cstddef>
+
+namespace robsec
+{
+
+/// @brief Checks if the allocations are being counted.
+/// @details They are counted only when the project is configured with
+/// `ROBSEC_COUNT_ALLOCATIONS`, which replaces the global `operator new`.
+/// @return true if the allocations are counted, false otherwise.
+bool counting_allocations();
+
+/// @brief Returns the number of calls to the global `operator new` so far.
+/// @return The number of allocations, or 0 if they are not counted.
+std::size_t allocation_count();
+
+} // namespace robsec
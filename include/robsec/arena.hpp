@@ -0,0 +1,113 @@
+/// @file arena.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Bump allocator releasing all its memory at once.
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace robsec
+{
+
+/// @brief Hands out memory by bumping a pointer inside large chunks, and
+/// releases all of it at once.
+/// @details Single allocations are never freed, `reset()` makes the whole
+/// arena available again. When the memory was split over several chunks,
+/// the reset merges them into a single one, so once the arena has grown to
+/// the size of its usual content it does not call the heap anymore.
+class Arena {
+private:
+    /// @brief A block of memory taken from the heap.
+    struct Chunk {
+        char *data;       ///< Pointer to the first byte of the chunk.
+        std::size_t size; ///< Size of the chunk in bytes.
+    };
+
+    std::size_t chunk_size;    ///< Minimum size of a new chunk.
+    std::vector<Chunk> chunks; ///< The chunks, the last one is the current one.
+    std::size_t used;          ///< Bytes used in the current chunk.
+
+public:
+    /// @brief Constructs an empty arena, the first chunk is taken on the first allocation.
+    /// @param _chunk_size The minimum size of a chunk, in bytes.
+    explicit Arena(std::size_t _chunk_size);
+
+    /// @brief Releases all the chunks.
+    ~Arena();
+
+    Arena(const Arena &)            = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    /// @brief Allocates a block of memory.
+    /// @param size The size of the block, in bytes.
+    /// @param alignment The alignment of the block, a power of two.
+    /// @return A pointer to the block, valid until the next reset.
+    void *allocate(std::size_t size, std::size_t alignment);
+
+    /// @brief Makes all the memory available again, invalidating every block.
+    void reset();
+
+    /// @brief Returns the total size of the chunks, in bytes.
+    std::size_t get_capacity() const;
+};
+
+/// @brief Standard allocator taking its memory from an arena.
+/// @details Deallocation does nothing, the memory is released by `Arena::reset()`.
+/// The allocator follows the containers when they are moved or swapped.
+template <typename T>
+class ArenaAllocator {
+public:
+    typedef T value_type; ///< Type of the allocated objects.
+
+    typedef std::true_type propagate_on_container_copy_assignment; ///< Copies share the arena.
+    typedef std::true_type propagate_on_container_move_assignment; ///< Moves keep the arena.
+    typedef std::true_type propagate_on_container_swap;            ///< Swaps exchange the arenas.
+
+    Arena *arena; ///< The arena the memory is taken from.
+
+    /// @brief Constructs an allocator over the given arena.
+    explicit ArenaAllocator(Arena &_arena)
+        : arena(&_arena)
+    {
+    }
+
+    /// @brief Constructs an allocator over the same arena of another one.
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U> &other)
+        : arena(other.arena)
+    {
+    }
+
+    /// @brief Allocates room for the given number of objects.
+    T *allocate(std::size_t n)
+    {
+        return static_cast<T *>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    /// @brief Does nothing, the memory is released when the arena is reset.
+    void deallocate(T *, std::size_t)
+    {
+    }
+};
+
+/// @brief Two allocators are equal when they share the arena.
+template <typename T, typename U>
+inline bool operator==(const ArenaAllocator<T> &lhs, const ArenaAllocator<U> &rhs)
+{
+    return lhs.arena == rhs.arena;
+}
+
+/// @brief Two allocators are different when they do not share the arena.
+template <typename T, typename U>
+inline bool operator!=(const ArenaAllocator<T> &lhs, const ArenaAllocator<U> &rhs)
+{
+    return lhs.arena != rhs.arena;
+}
+
+/// @brief Vector whose storage is taken from an arena.
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+} // namespace robsec
@@ -0,0 +1,225 @@
+/// @file board.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Board of the game and its curses-free generator.
+
+#pragma once
+
+#include "robsec/arena.hpp"
+#include "robsec/dictionary.hpp"
+#include "robsec/free_space.hpp"
+#include "robsec/likeness.hpp"
+#include "robsec/likeness_index.hpp"
+#include "robsec/random.hpp"
+#include "robsec/stats.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace robsec
+{
+
+/// @brief Represents a location within the game grid.
+class GameLocation {
+public:
+    std::size_t panel;  ///< Panel index in the game grid.
+    std::size_t column; ///< Column index within the panel.
+    std::size_t row;    ///< Row index within the panel.
+
+    /// @brief Constructs a GameLocation with the given panel, column, and row.
+    constexpr GameLocation(std::size_t _panel, std::size_t _column, std::size_t _row)
+        : panel(_panel), column(_column), row(_row)
+    {
+    }
+};
+
+/// @brief Represents a screen location in absolute coordinates.
+class ScreenLocation {
+public:
+    std::size_t x; ///< X-coordinate on the screen.
+    std::size_t y; ///< Y-coordinate on the screen.
+
+    /// @brief Constructs a ScreenLocation with the given x and y coordinates.
+    constexpr ScreenLocation(std::size_t _x, std::size_t _y)
+        : x(_x), y(_y)
+    {
+    }
+};
+
+/// @brief The content of a game board, independent from how it is displayed.
+/// @details All the memory of the board, including the scratch buffers of
+/// its generation, is taken from an arena owned by the board, and `clear()`
+/// releases it at once. The arena lives on the heap, so moving or swapping
+/// a board keeps its containers pointing at it.
+struct Board {
+    /// @brief Value of a cell which is not covered by any word.
+    static const uint32_t no_word;
+
+    /// @brief The characters the garbage is drawn from, some more often than others.
+    static const char garbage[];
+
+    std::unique_ptr<Arena> arena;      ///< Storage of all the board-scoped containers.
+    std::size_t n_panels;              ///< Number of panels.
+    std::size_t n_rows;                ///< Number of rows per panel.
+    std::size_t n_columns;             ///< Number of columns per panel.
+    std::size_t start_address;         ///< Starting address for the game display.
+    const DictionaryGroup *group;      ///< Group the words are taken from, null if empty.
+    ArenaVector<uint32_t> word_ids;    ///< Index of each placed word inside the group.
+    ArenaVector<uint32_t> word_panels; ///< Panel of each placed word.
+    ArenaVector<uint32_t> word_starts; ///< Linear position of the first letter of each placed word.
+    std::size_t solution_index;        ///< Index of the solution among the words.
+    ArenaVector<char> content;         ///< Garbage content of the panels, one after the other.
+    ArenaVector<uint32_t> cells;       ///< Index of the word covering each cell, panel after panel.
+    ArenaVector<uint32_t> pairs;       ///< Length of the bracket pair opening at each cell, 0 if none, panel after panel.
+    LikenessMatrix likeness;           ///< Likeness between every pair of words.
+
+    /// @brief Constructs an empty board.
+    Board();
+
+    /// @brief Removes all the words and the content from the board, releasing
+    /// their memory to the arena with a single reset.
+    void clear();
+
+    /// @brief Rebuilds the cell-to-word table from the placed words.
+    void index_words();
+
+    /// @brief Rebuilds the table of the bracket pairs, from the content and the words.
+    /// @details A pair is an opening bracket and the nearest closing bracket
+    /// of the same kind after it, in the same row, with no word between them.
+    void index_brackets();
+
+    /// @brief Turns a word into garbage, replacing its letters with dots.
+    /// @param index The index of the word.
+    void remove_word(std::size_t index);
+
+    /// @brief Checks if a word was turned into garbage.
+    /// @param index The index of the word.
+    inline bool is_removed(std::size_t index) const
+    {
+        return this->word_at(word_panels[index], word_starts[index]) != index;
+    }
+
+    /// @brief Returns the length of the bracket pair opening at the given cell, or 0.
+    /// @param panel The panel of the cell.
+    /// @param position The linear position of the cell inside the panel.
+    inline std::size_t pair_at(std::size_t panel, std::size_t position) const
+    {
+        std::size_t cell = panel * n_rows * n_columns + position;
+        return (cell < pairs.size()) ? pairs[cell] : 0;
+    }
+
+    /// @brief Uses up the bracket pair opening at the given cell.
+    /// @param panel The panel of the cell.
+    /// @param position The linear position of the cell inside the panel.
+    inline void consume_pair(std::size_t panel, std::size_t position)
+    {
+        pairs[panel * n_rows * n_columns + position] = 0;
+    }
+
+    /// @brief Returns the index of the word covering the given cell, or `no_word`.
+    /// @param panel The panel of the cell.
+    /// @param position The linear position of the cell inside the panel.
+    inline uint32_t word_at(std::size_t panel, std::size_t position) const
+    {
+        std::size_t cell = panel * n_rows * n_columns + position;
+        return (cell < cells.size()) ? cells[cell] : no_word;
+    }
+
+    /// @brief Returns the garbage content of the given panel, row after row.
+    inline const char *get_panel(std::size_t panel) const
+    {
+        return content.data() + panel * n_rows * n_columns;
+    }
+
+    /// @brief Returns the number of placed words.
+    inline std::size_t get_n_words() const
+    {
+        return word_ids.size();
+    }
+
+    /// @brief Returns the length shared by all the placed words.
+    inline std::size_t get_word_length() const
+    {
+        return group ? group->length : 0;
+    }
+
+    /// @brief Returns the characters of the i-th placed word.
+    inline WordView get_word(std::size_t i) const
+    {
+        return (*group)[word_ids[i]];
+    }
+
+    /// @brief Returns the characters of the solution.
+    inline WordView get_solution() const
+    {
+        return this->get_word(solution_index);
+    }
+};
+
+/// @brief How alike the words of a board are to its solution.
+enum Difficulty {
+    Unrated, ///< The words are picked at random.
+    Easy,    ///< A quarter of the words are among the most alike to the solution, the likeness of the others is spread.
+    Medium,  ///< Half of the words are among the most alike to the solution.
+    Hard     ///< All the words are among the most alike to the solution.
+};
+
+/// @brief Parses the name of a difficulty: `easy`, `medium` or `hard`.
+/// @param name The name to parse.
+/// @param difficulty Receives the difficulty.
+/// @return true if the name is valid, false otherwise.
+bool parse_difficulty(const std::string &name, Difficulty &difficulty);
+
+/// @brief Generates boards from a dictionary, without any dependency on the display.
+class BoardGenerator {
+private:
+    const Dictionary &dictionary; ///< The dictionary the words are taken from.
+    std::size_t n_panels;         ///< Number of panels in the board.
+    std::size_t n_rows;           ///< Number of rows per panel.
+    std::size_t n_columns;        ///< Number of columns per panel.
+    std::size_t n_words;          ///< Number of words in the board.
+    const LikenessIndex *index;   ///< The index of the dictionary, if the difficulty is rated.
+    Difficulty difficulty;        ///< The difficulty of the boards.
+
+public:
+    /// @brief Constructs a generator for the given layout.
+    BoardGenerator(const Dictionary &_dictionary, std::size_t _n_panels, std::size_t _n_rows, std::size_t _n_columns, std::size_t _n_words);
+
+    /// @brief Sets the difficulty of the next boards.
+    /// @param _index The likeness index of the dictionary, which must outlive the generator.
+    /// @param _difficulty The difficulty, `Unrated` picks the words at random.
+    void set_difficulty(const LikenessIndex *_index, Difficulty _difficulty);
+
+    /// @brief Fills the board with a new set of words, content, solution and start address.
+    /// @param board The board to fill.
+    /// @param engine The random engine used for every random choice.
+    /// @return true on success, false otherwise.
+    bool generate(Board &board, RandomEngine &engine) const;
+
+    /// @brief Fills the board, like generate(), timing each phase of the generation.
+    /// @param timings If not null, receives the duration of each phase.
+    bool generate(Board &board, RandomEngine &engine, GenerationTimings *timings) const;
+
+private:
+    /// @brief Picks distinct words of the group at random, with Floyd's algorithm.
+    void select_random_words(Board &board, std::size_t total_words, RandomEngine &engine) const;
+
+    /// @brief Picks the words around a random solution, following the difficulty.
+    /// @return The index of the solution among the words.
+    std::size_t select_rated_words(Board &board, std::size_t total_words, RandomEngine &engine) const;
+
+    /// @brief Finds a valid position for a word that doesn't overlap with the ones already placed.
+    /// @param panel Receives the panel of the word.
+    /// @param start Receives the linear position of the first letter of the word.
+    bool find_unoccupied_space_for_word(FreeSpaceIndex &free_space, std::size_t remaining, std::size_t &panel, std::size_t &start, RandomEngine &engine) const;
+};
+
+/// @brief Writes the board in a plain-text format, with the words placed over the garbage.
+/// @param out The output stream.
+/// @param board The board to write.
+/// @return The output stream.
+std::ostream &operator<<(std::ostream &out, const Board &board);
+
+} // namespace robsec
@@ -0,0 +1,66 @@
+/// @file board_prefetcher.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Background generation of the boards, ahead of their use.
+
+#pragma once
+
+#include "robsec/board.hpp"
+#include "robsec/random.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace robsec
+{
+
+/// @brief Keeps a bounded queue of boards ready, filled by a worker thread.
+/// @details The queue is a single-producer single-consumer ring: the worker
+/// is its only producer, and `pop()` must be called by one thread at a time.
+/// Boards are swapped in and out of the ring, so their buffers are recycled.
+/// The boards come out in the order they are generated, from a single random
+/// engine, so the same seed gives the same sequence of boards.
+class BoardPrefetcher {
+private:
+    BoardGenerator generator;          ///< Generator of the boards.
+    RandomEngine engine;               ///< Random engine of the worker.
+    std::vector<Board> ring;           ///< The slots of the queue, one more than its capacity.
+    std::atomic<std::size_t> head;     ///< Next slot to pop, owned by the consumer.
+    std::atomic<std::size_t> tail;     ///< Next slot to fill, owned by the worker.
+    std::atomic<bool> failed;          ///< If the worker failed to generate a board.
+    std::atomic<bool> stopping;        ///< If the worker must stop.
+    std::mutex mutex;                  ///< Only used to sleep on the condition variables.
+    std::condition_variable not_full;  ///< Signaled when a board is popped, or on stop.
+    std::condition_variable not_empty; ///< Signaled when a board is ready, or on failure.
+    std::thread worker;                ///< The thread generating the boards.
+
+public:
+    /// @brief Starts the worker, which fills the queue right away.
+    /// @param _generator The generator of the boards, copied with its layout and
+    /// difficulty. Its dictionary must outlive the prefetcher.
+    /// @param _capacity The number of boards kept ready.
+    /// @param _seed The seed of the random engine (0 for a random one).
+    BoardPrefetcher(const BoardGenerator &_generator, std::size_t _capacity, unsigned _seed);
+
+    /// @brief Stops the worker, discarding the boards not yet popped.
+    ~BoardPrefetcher();
+
+    BoardPrefetcher(const BoardPrefetcher &)            = delete;
+    BoardPrefetcher &operator=(const BoardPrefetcher &) = delete;
+
+    /// @brief Takes the oldest ready board, waiting for one if the queue is empty.
+    /// @param board Receives the board, its previous buffers are given back to the worker.
+    /// @return true on success, false if the worker failed to generate the board.
+    bool pop(Board &board);
+
+    /// @brief Returns the number of boards ready.
+    std::size_t get_size() const;
+
+private:
+    /// @brief Body of the worker thread.
+    void run();
+};
+
+} // namespace robsec
@@ -0,0 +1,154 @@
+/// @file dictionary.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Dictionary of words used to build the game boards.
+
+#pragma once
+
+#include "robsec/mapped_file.hpp"
+
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace robsec
+{
+
+/// @brief Non-owning reference to a null-terminated word stored in the dictionary arena.
+class WordView {
+public:
+    const char *data;   ///< Pointer to the first character of the word.
+    std::size_t length; ///< Number of characters in the word.
+
+    /// @brief Constructs a view over the given characters.
+    WordView(const char *_data, std::size_t _length)
+        : data(_data), length(_length)
+    {
+    }
+
+    /// @brief Returns an owned copy of the word.
+    std::string to_string() const
+    {
+        return std::string(data, length);
+    }
+
+    /// @brief Equality operator to compare views by their characters.
+    bool operator==(const WordView &rhs) const
+    {
+        return (length == rhs.length) && (std::memcmp(data, rhs.data, length) == 0);
+    }
+};
+
+/// @brief Represents a group of words with the same length.
+/// @details The words of a group are packed one after the other in the
+/// dictionary storage, each followed by a null terminator.
+struct DictionaryGroup {
+    std::size_t length; ///< Length of the words in the group.
+    std::size_t count;  ///< Number of words in the group.
+    const char *data;   ///< Pointer to the first word of the group.
+
+    /// @brief Returns the number of words in the group.
+    inline std::size_t size() const
+    {
+        return count;
+    }
+
+    /// @brief Returns the word at the given index.
+    inline WordView operator[](std::size_t index) const
+    {
+        return WordView(data + index * (length + 1), length);
+    }
+
+    /// @brief Equality operator to compare groups by their length.
+    inline bool operator==(const DictionaryGroup &other) const
+    {
+        return length == other.length;
+    }
+};
+
+/// @brief The list of words, in uppercase, grouped by their length.
+/// @details Every word is stored once, null-terminated, in a single contiguous
+/// storage sorted by length, and the groups are views into it. A text
+/// dictionary is parsed into an owned arena, while a compiled dictionary
+/// (see `Dictionary::compile`) is mapped and used as it is.
+class Dictionary {
+private:
+    MappedFile mapping;                  ///< Mapping of a compiled dictionary.
+    std::vector<char> arena;             ///< Storage of the words of a text dictionary.
+    std::size_t size;                    ///< Total number of words.
+    std::vector<DictionaryGroup> groups; ///< Non-empty groups of words, sorted by length.
+
+public:
+    /// @brief Constructs an empty dictionary.
+    Dictionary();
+
+    Dictionary(const Dictionary &)            = delete;
+    Dictionary &operator=(const Dictionary &) = delete;
+
+    /// @brief Loads the dictionary from the specified path.
+    /// @details The format (text or compiled) is detected from the content of the file.
+    /// @param path The path to the dictionary file.
+    /// @return true if the dictionary was loaded, false otherwise.
+    bool load(const std::string &path);
+
+    /// @brief Loads and merges several text dictionaries, in parallel.
+    /// @details The inputs are split in chunks at the separators, and each
+    /// chunk is tokenized, converted to uppercase and bucketed by length on
+    /// its own thread. The words keep the order of the inputs, so the result
+    /// does not depend on the number of threads. A single input may also be
+    /// a compiled dictionary, which is mapped as it is.
+    /// @param paths The paths to the dictionary files.
+    /// @param n_threads The number of threads, 0 for one per hardware thread.
+    /// @param deduplicate If the repeated words must be kept only once.
+    /// @return true if the dictionary was loaded, false otherwise.
+    bool load(const std::vector<std::string> &paths, std::size_t n_threads, bool deduplicate);
+
+    /// @brief Expands a comma-separated list of files and directories into
+    /// the list of files to load.
+    /// @details The files of a directory are taken in alphabetical order,
+    /// skipping the hidden ones and the subdirectories.
+    /// @param list The comma-separated list of paths.
+    /// @param files Where the paths of the files are appended.
+    /// @return true if all the paths exist, false otherwise.
+    static bool list_files(const std::string &list, std::vector<std::string> &files);
+
+    /// @brief Writes the dictionary in the compiled binary format.
+    /// @param path The path of the output file.
+    /// @return true if the dictionary was written, false otherwise.
+    bool save(const std::string &path) const;
+
+    /// @brief Loads a dictionary and writes it in the compiled binary format.
+    /// @param input_path The path to the dictionary to compile.
+    /// @param output_path The path of the compiled dictionary.
+    /// @return true on success, false otherwise.
+    static bool compile(const std::string &input_path, const std::string &output_path);
+
+    /// @brief Checks every word, as the text loader would have written it.
+    /// @details Loading a compiled dictionary only checks its header and its
+    /// group table; this reads all of it, for the files that are not trusted.
+    /// @return true if every word is uppercase and null-terminated, false otherwise.
+    bool verify() const;
+
+    /// @brief Returns the total number of words.
+    std::size_t get_size() const;
+
+    /// @brief Returns the non-empty groups of words, sorted by length.
+    const std::vector<DictionaryGroup> &get_groups() const;
+
+private:
+    /// @brief Parses text dictionaries, one or more words per line, in parallel.
+    /// @param inputs The beginning and the end of each dictionary.
+    /// @param n_threads The number of threads, 0 for one per hardware thread.
+    bool parse_text(const std::vector<std::pair<const char *, const char *>> &inputs, std::size_t n_threads);
+
+    /// @brief Removes the repeated words of each group, keeping the first occurrence.
+    /// @param n_threads The number of threads, 0 for one per hardware thread.
+    void deduplicate(std::size_t n_threads);
+
+    /// @brief Validates a compiled dictionary and builds the groups over it.
+    /// @details It reads the header and the group table only: each group must be
+    /// in bounds and terminated, and the groups must add up to the words in the header.
+    bool parse_binary(const char *begin, const char *end);
+};
+
+} // namespace robsec
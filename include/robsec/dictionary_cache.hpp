@@ -0,0 +1,39 @@
+/// @file dictionary_cache.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Process-wide cache of the loaded dictionaries.
+
+#pragma once
+
+#include "robsec/dictionary.hpp"
+
+#include <memory>
+#include <string>
+
+namespace robsec
+{
+
+/// @brief Shares the loaded dictionaries among all their users in the process.
+/// @details A dictionary is loaded the first time it is requested, and it is
+/// shared read-only until its last user releases it. It is loaded again if
+/// the file was modified in the meantime.
+class DictionaryCache {
+public:
+    /// @brief Returns the dictionary at the given path, loading it if needed.
+    /// @details It is safe to call from multiple threads.
+    /// @param path The path to the dictionary, either text or compiled.
+    /// @return The dictionary, or an empty pointer if it fails to load.
+    static std::shared_ptr<const Dictionary> acquire(const std::string &path);
+
+    /// @brief Returns the merge of the given dictionaries, loading it if needed.
+    /// @details It is loaded again if any of the files was modified, added or
+    /// removed in the meantime. It is safe to call from multiple threads.
+    /// @param paths The comma-separated list of dictionary files and directories.
+    /// @param deduplicate If the repeated words must be kept only once.
+    /// @return The dictionary, or an empty pointer if it fails to load.
+    static std::shared_ptr<const Dictionary> acquire(const std::string &paths, bool deduplicate);
+
+    /// @brief Returns the number of dictionaries currently shared.
+    static std::size_t get_size();
+};
+
+} // namespace robsec
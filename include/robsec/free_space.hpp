@@ -0,0 +1,81 @@
+/// @file free_space.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Index of the free space left in the panels of a board.
+
+#pragma once
+
+#include "robsec/arena.hpp"
+#include "robsec/random.hpp"
+
+namespace robsec
+{
+
+/// @brief Keeps track of the free intervals of every panel, so that a valid
+/// start for a span can be sampled directly.
+/// @details Each free interval is stored in a slot, and two Fenwick trees
+/// over the slots count the valid starts each interval offers: all of them,
+/// and only those that do not waste room for another span. Sampling and
+/// occupying a span take O(log n) in the number of intervals. When the free
+/// space is just enough for the spans still to be placed, only starts that
+/// do not waste room are sampled, so placing them always succeeds whenever
+/// they fit at all.
+class FreeSpaceIndex {
+private:
+    /// @brief A free interval [begin, end) inside a panel.
+    struct Interval {
+        std::size_t panel; ///< Panel of the interval.
+        std::size_t begin; ///< First free cell.
+        std::size_t end;   ///< One past the last free cell.
+    };
+
+    std::size_t span;               ///< Number of cells taken by each span.
+    std::size_t max_slots;          ///< Maximum number of slots.
+    std::size_t capacity;           ///< How many more spans fit in the free intervals.
+    ArenaVector<Interval> slots;    ///< The free intervals.
+    ArenaVector<std::size_t> loose; ///< Fenwick tree of all the valid starts per slot.
+    ArenaVector<std::size_t> tight; ///< Fenwick tree of the valid starts that waste no room.
+
+public:
+    /// @brief Constructs an empty index.
+    /// @param arena The arena the intervals and the trees are allocated from.
+    explicit FreeSpaceIndex(Arena &arena);
+
+    /// @brief Resets the index to completely free panels.
+    /// @param n_panels The number of panels.
+    /// @param n_cells The number of cells in each panel.
+    /// @param _span The number of cells taken by each span.
+    /// @param max_spans The maximum number of spans that will be occupied.
+    void reset(std::size_t n_panels, std::size_t n_cells, std::size_t _span, std::size_t max_spans);
+
+    /// @brief Returns how many more spans fit in the free space.
+    std::size_t get_capacity() const;
+
+    /// @brief Samples a valid start, and marks the span as occupied.
+    /// @param engine The random engine.
+    /// @param remaining The number of spans still to place, including this one.
+    /// @param panel Where the panel of the span is stored.
+    /// @param start Where the first cell of the span is stored.
+    /// @return true if there was space for the remaining spans, false otherwise.
+    bool occupy_random(RandomEngine &engine, std::size_t remaining, std::size_t &panel, std::size_t &start);
+
+private:
+    /// @brief Appends a new interval, in a new slot.
+    void push(const Interval &interval);
+
+    /// @brief Replaces the interval of the given slot.
+    void update(std::size_t slot, const Interval &interval);
+
+    /// @brief Returns the valid starts inside the interval.
+    std::size_t loose_weight(const Interval &interval) const;
+
+    /// @brief Returns the valid starts inside the interval which waste no room.
+    std::size_t tight_weight(const Interval &interval) const;
+
+    /// @brief Returns the sum of all the slots of the tree.
+    std::size_t total(const ArenaVector<std::size_t> &tree) const;
+
+    /// @brief Finds the slot containing the given start, and the offset inside it.
+    std::size_t find(const ArenaVector<std::size_t> &tree, std::size_t &offset) const;
+};
+
+} // namespace robsec
@@ -4,126 +4,51 @@
 
 #pragma once
 
+#include "robsec/board.hpp"
+#include "robsec/board_prefetcher.hpp"
+#include "robsec/dictionary.hpp"
+#include "robsec/input_log.hpp"
+#include "robsec/layout.hpp"
+#include "robsec/random.hpp"
+#include "robsec/render_target.hpp"
+#include "robsec/solver.hpp"
+#include "robsec/stats.hpp"
+
+#include <memory>
 #include <string>
 #include <vector>
-#include <map>
+
+/// @brief Interval between two frames of the typewriter animation, in milliseconds.
+#define ANIMATION_TICK_MS 20
 
 /// @brief Namespace for the RobCo hacking game.
 namespace robsec
 {
 
-/// @brief Represents a location within the game grid.
-class GameLocation {
-public:
-    std::size_t panel;  ///< Panel index in the game grid.
-    std::size_t column; ///< Column index within the panel.
-    std::size_t row;    ///< Row index within the panel.
-
-    /// @brief Constructs a GameLocation with the given panel, column, and row.
-    GameLocation(std::size_t _panel, std::size_t _column, std::size_t _row)
-        : panel(_panel), column(_column), row(_row)
-    {
-    }
-};
-
-/// @brief Represents a screen location in absolute coordinates.
-class ScreenLocation {
-public:
-    std::size_t x; ///< X-coordinate on the screen.
-    std::size_t y; ///< Y-coordinate on the screen.
-
-    /// @brief Constructs a ScreenLocation with the given x and y coordinates.
-    ScreenLocation(std::size_t _x, std::size_t _y)
-        : x(_x), y(_y)
-    {
-    }
-};
-
-/// @brief Represents a word in the game, including its position and metadata.
-class Word {
+/// @brief Represents the main game logic for the RobCo hacking emulator.
+/// @details The layout of the panels is either fixed at compile time, so that
+/// the coordinate math folds into constants, or given at run time when all
+/// the sizes are zero, see `Game` and `StandardGame`.
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+class BasicGame {
 public:
-    std::size_t panel;                       ///< Panel where the word starts.
-    std::size_t start;                       ///< Start position of the word.
-    std::size_t end;                         ///< End position of the word.
-    std::string string;                      ///< The word itself.
-    std::vector<ScreenLocation> coordinates; ///< Screen coordinates of the word.
-
-    /// @brief Constructs a Word object with the specified parameters.
-    Word(std::size_t _panel, std::size_t _start, std::string _string)
-        : panel(_panel), start(_start), end(_start + _string.length()), string(_string), coordinates()
-    {
-        // Initialization of the word's coordinates.
-    }
-
-    /// @brief Clears the word's data, resetting most members to default values,
-    /// except for the string itself.
-    void reset()
-    {
-        panel = 0;           // Reset the panel index.
-        start = 0;           // Reset the start position.
-        end   = 0;           // Reset the end position.
-        coordinates.clear(); // Clear the vector of screen coordinates.
-    }
-
-    /// @brief Equality operator to compare words by their string value.
-    bool operator==(const Word &rhs) const
-    {
-        return this->string == rhs.string;
-    }
-
-    /// @brief Checks if the word overlaps with another word.
-    bool overlap(const Word &rhs) const
-    {
-        return (start <= rhs.end) && (rhs.start <= end);
-    }
-
-    /// @brief Checks if the word overlaps with any word in the given list.
-    inline bool overlap(const std::vector<Word> &words) const
-    {
-        for (const auto &other : words) {
-            if (this->overlap(other)) {
-                return true;
-            }
-        }
-        return false;
-    }
-
-    /// @brief Determines if the word is currently selected based on position.
-    bool is_selected(std::size_t c, std::size_t position) const
-    {
-        return (panel == c) && (start <= position) && (position < end);
-    }
-};
-
-/// @brief Represents a group of words with the same length.
-struct DictionaryGroup {
-    std::size_t length;             ///< Length of the words in the group.
-    std::vector<std::string> words; ///< List of words of this length.
+    /// @brief The result of a wrong guess.
+    struct Feedback {
+        std::size_t word; ///< Index of the guessed word.
+        int likeness;     ///< Number of letters in common with the solution.
+    };
 
-    /// @brief Equality operator to compare groups by their length.
-    inline bool operator==(const DictionaryGroup &other) const
-    {
-        return length == other.length;
-    }
-};
-
-/// @brief Represents the main game logic for the RobCo hacking emulator.
-class Game {
 private:
-    std::string dictionary_path;                    ///< Path to the dictionary file.
-    std::vector<std::string> dictionary;            ///< The full list of dictionary words.
-    std::vector<DictionaryGroup> sorted_dictionary; ///< Dictionary sorted by word length.
-    std::size_t start_address;                      ///< Starting address for the game display.
-    std::size_t n_panels;                           ///< Number of panels in the game.
-    std::size_t n_rows;                             ///< Number of rows per panel.
-    std::size_t n_columns;                          ///< Number of columns per panel.
+    RenderTarget &target;                           ///< Where the game is rendered to.
+    std::shared_ptr<const Dictionary> dictionary;   ///< The dictionary the words are taken from, shared.
+    Layout<Panels, Rows, Columns> layout;           ///< Sizes of the panels.
     std::size_t n_words;                            ///< Number of words in the game.
     int attempts_max;                               ///< Maximum number of allowed attempts.
     int attempts;                                   ///< Remaining number of attempts.
     GameLocation position;                          ///< Current cursor position.
-    std::string solution;                           ///< Correct word to guess.
-    std::vector<Word> words;                        ///< Words used in the game.
-    std::vector<std::string> content;               ///< Panel contents for display.
+    BoardGenerator generator;                       ///< Generator of the game board.
+    BoardPrefetcher *prefetcher;                    ///< Source of ready boards, if any.
+    Board board;                                    ///< Words, content and solution of the game.
     enum GameState {
         Running,      ///< Game is running.
         MousePressed, ///< Mouse button pressed.
@@ -131,69 +56,236 @@ private:
         Won,          ///< Game won.
         Lost,         ///< Game lost.
     } state;          ///< Current game state.
+    std::vector<Feedback> feedback; ///< The wrong guesses, in order.
+    std::vector<uint32_t> removed;  ///< The duds removed with a bracket pair, in order.
+    int notice;                     ///< The prompt shown while the round goes on, after a bracket pair.
+    bool animated;                  ///< If the header and the feedback are typed one character at the time.
+    std::size_t typed;              ///< Characters of the header and of the feedback typed so far.
+    std::size_t scrolled;           ///< Wrong guesses scrolled out of the log, which shows the last `attempts_max` ones.
+    Solver solver;                  ///< Keeps track of the candidates, to suggest a guess.
+    /// @brief What is currently painted on the screen, used to repaint only what changed.
+    struct Painted {
+        bool scene;              ///< If the static part of the scene was painted.
+        int attempts;            ///< The attempts shown on the screen.
+        uint32_t selection;      ///< The word shown as selected.
+        std::size_t pair;        ///< The cell opening the bracket pair shown as selected, or SIZE_MAX.
+        std::size_t pair_length; ///< The length of the bracket pair shown as selected.
+        std::size_t removed;     ///< The number of removed duds shown.
+        std::size_t typed;       ///< The number of characters of the header and of the feedback shown.
+        std::size_t scrolled;    ///< The number of wrong guesses scrolled out of the log shown.
+        int feedback_x;          ///< Column of the first feedback line.
+        int feedback_y;          ///< Row of the first feedback line.
+        int prompt;              ///< The prompt shown below the panels.
+        Painted()
+            : scene(false), attempts(-1), selection(Board::no_word), pair(SIZE_MAX), pair_length(0), removed(0), typed(0), scrolled(0), feedback_x(0), feedback_y(0), prompt(-1)
+        {
+        }
+    } painted;                   ///< State of the screen.
+    typename Layout<Panels, Rows, Columns>::Addresses addresses; ///< Preformatted addresses, row after row and panel after panel.
+    std::size_t max_frame_allocations;                           ///< Maximum number of allocations done while painting a frame.
+    GameStats *stats;                                            ///< Where the statistics are collected, if any.
+    unsigned seed;                                               ///< Seed used to initialize the random engine.
+    RandomEngine engine;                                         ///< Random engine of the boards.
+    RandomEngine tricks;                                         ///< Random engine of the bracket pairs, seeded from each board.
 
 public:
     /// @brief Constructs the Game object with configuration parameters.
-    Game(std::string _dictionary_path, std::size_t _n_panels, std::size_t _n_rows, std::size_t _n_columns, std::size_t _n_words, int _attempts_max);
+    /// @details A seed of zero means the random engine is seeded from std::random_device.
+    /// When a prefetcher is given, the boards are taken from it instead of
+    /// being generated, and the seed is not used. With a fixed layout, the
+    /// sizes must be the ones of the template, see `matches()`.
+    BasicGame(RenderTarget &_target, std::shared_ptr<const Dictionary> _dictionary, std::size_t _n_panels, std::size_t _n_rows, std::size_t _n_columns, std::size_t _n_words, int _attempts_max, unsigned _seed, BoardPrefetcher *_prefetcher);
 
-    /// @brief Initializes the game, including loading the dictionary and setting up the grid.
+    /// @brief Initializes the game, generating the board and rendering it.
     bool initialize();
 
+    /// @brief Collects the statistics of the initialization and of the frames.
+    /// @details Call it before initialize(), to time the initialization too. With
+    /// no statistics object, which is the default, the clock is never read.
+    void set_stats(GameStats *_stats);
+
+    /// @brief Sets the difficulty of the boards, call it before initialize().
+    /// @details It does not apply to the boards taken from a prefetcher, which
+    /// has its own generator.
+    /// @param _index The likeness index of the dictionary, which must outlive the game.
+    /// @param _difficulty The difficulty, `Unrated` picks the words at random.
+    void set_difficulty(const LikenessIndex *_index, Difficulty _difficulty);
+
+    /// @brief Types the header and the feedback one character at the time, call it before initialize().
+    /// @details The typing advances only with tick(), by default everything is shown at once.
+    void set_animated(bool _animated);
+
+    /// @brief Returns true while some text is left to type, and tick() should be called.
+    bool is_animating() const;
+
+    /// @brief Advances the animation, rendering what changed.
+    /// @param n_ticks The number of ticks elapsed since the previous call.
+    /// @return true if the animation goes on.
+    bool tick(std::size_t n_ticks);
+
+    /// @brief Starts a new round on a new board, keeping the dictionary, the
+    /// target and the buffers of the previous round.
+    bool new_round();
+
+    /// @brief Appends the snapshot of the current round: the board, the attempts, the cursor and the guesses.
+    /// @details See `serialize_board()` for the format of the board.
+    /// @return true on success, false otherwise.
+    bool serialize(std::vector<char> &buffer) const;
+
+    /// @brief Resumes the round of a snapshot, and repaints the whole scene.
+    /// @details Call it after initialize(). The snapshot must come from a game
+    /// with the same layout and dictionary. The following rounds are drawn
+    /// from the engine reseeded with the seed of the snapshot and its board,
+    /// so they do not depend on the game resuming it.
+    /// @return true on success, false if the snapshot does not fit the game,
+    /// which then keeps its round.
+    bool deserialize(const char *data, std::size_t size);
+
     /// @brief Stops the game and resets resources.
     void stop();
 
-    /// @brief Main game loop for handling events and rendering.
-    bool run();
-    
+    /// @brief Main game loop, reading the keys from ncurses.
+    /// @param coalesce If true, all the keys already pending are handled before
+    /// rendering a single frame, instead of rendering a frame for each key.
+    /// @param recorder If not null, it records every input.
+    /// @return true if the game was won, false otherwise.
+    bool run(bool coalesce, InputRecorder *recorder);
+
+    /// @brief Handles a single key, rendering what changed.
+    /// @details Once the round is over, 'r' starts a new one and the other keys are ignored.
+    /// @return true if the round goes on, false if it is over.
+    bool handle_key(int key);
+
+    /// @brief Handles the given inputs in order, then renders a single frame.
+    /// @return true if the round goes on, false if it is over.
+    bool handle_input(const InputEvent *events, std::size_t n_events);
+
+    /// @brief Returns true if the round was won.
+    bool has_won() const;
+
+    /// @brief Returns true if the round was either won or lost.
+    bool is_over() const;
+
+    /// @brief Returns the board of the current round, valid until the next one.
+    const Board &get_board() const;
+
+    /// @brief Returns the wrong guesses of the current round, in order.
+    const std::vector<Feedback> &get_feedback() const;
+
+    /// @brief Returns the current cursor position.
+    const GameLocation &get_position() const;
+
+    /// @brief Returns the remaining number of attempts.
+    int get_attempts() const;
+
+    /// @brief Returns the maximum number of attempts.
+    int get_attempts_max() const;
+
+    /// @brief Returns the index of the currently selected word, or `Board::no_word`.
+    uint32_t find_selected_word() const;
+
+    /// @brief Returns the cell opening the currently selected bracket pair, panel after panel, or SIZE_MAX.
+    std::size_t find_selected_pair() const;
+
+    /// @brief Returns true if the game can be played with the given layout.
+    static bool matches(std::size_t n_panels, std::size_t n_rows, std::size_t n_columns);
+
+    /// @brief Returns the size of the screen needed by the given layout.
+    /// @return The number of columns and rows of the screen.
+    static ScreenLocation get_screen_size(std::size_t n_panels, std::size_t n_rows, std::size_t n_columns, int attempts_max);
+
+    /// @brief Returns the maximum number of allocations done while painting a single frame.
+    /// @details It is always zero unless the allocations are counted, see `counting_allocations()`.
+    std::size_t get_max_frame_allocations() const;
 
 private:
-    /// @brief Renders the game screen.
-    bool render();
+    /// @brief Applies an input to the state of the game, without rendering.
+    void apply_input(const InputEvent &event);
 
-    /// @brief Handles input from the user.
-    void parse_input(int key);
+    /// @brief Generates a new board and resets the state of the round.
+    /// @param timings If not null, receives the duration of the phases of the generation.
+    bool prepare_round(GenerationTimings *timings);
 
-    /// @brief Parses mouse input and updates the location accordingly.
-    bool parse_mouse_position(int key, GameLocation &location) const;
+    /// @brief Seeds the engine of the bracket pairs from the seed of the game and the board.
+    /// @details The boards may come from a prefetcher, with its own engine, so
+    /// the draws of a round must not change the engine of the boards either.
+    void seed_tricks();
 
-    /// @brief Parses keyboard input and updates the location accordingly.
-    bool parse_key_position(int key, GameLocation &location) const;
+    /// @brief Formats the addresses of the rows of the board.
+    void format_addresses();
 
-    /// @brief Finds a valid position for a word that doesn't overlap with others.
-    bool find_unoccupied_space_for_word(Word &word) const;
+    /// @brief Scrolls the log of the wrong guesses, so that it fits the rows reserved for it.
+    void scroll_feedback();
 
-    /// @brief Computes the memory address for a given row and panel.
-    std::size_t compute_address(std::size_t row, std::size_t panel) const;
+    /// @brief Applies the pending guess, if any, updating attempts, feedback and state.
+    void update();
+
+    /// @brief Uses up the selected bracket pair, which removes a dud or replenishes the attempts.
+    void apply_pair();
+
+    /// @brief Renders the parts of the game screen that changed since the last call.
+    bool render();
 
-    /// @brief Converts a GameLocation to a ScreenLocation.
-    ScreenLocation to_screen_location(const GameLocation &location) const;
+    /// @brief Renders the static part of the screen: header, addresses, content and words.
+    bool render_scene();
 
-    /// @brief Converts a ScreenLocation to a GameLocation.
-    GameLocation to_game_location(const ScreenLocation &location) const;
+    /// @brief Renders the line with the remaining attempts.
+    bool render_attempts();
 
-    /// @brief Converts a linear position to a GameLocation.
-    GameLocation linear_to_game_location(std::size_t panel, std::size_t position) const;
+    /// @brief Renders the word with the given index, either selected or not.
+    bool render_word(std::size_t index, bool selected);
 
-    /// @brief Converts a linear position to a ScreenLocation.
-    ScreenLocation linear_to_screen_location(std::size_t panel, std::size_t position) const;
+    /// @brief Renders some garbage of a panel, wrapping at the end of the rows.
+    /// @param cell The first cell, panel after panel.
+    /// @param length The number of cells.
+    /// @param attribute The attribute of the garbage.
+    bool render_garbage(std::size_t cell, std::size_t length, TextAttribute attribute);
 
-    /// @brief Moves the cursor to the specified panel, column, and row.
-    void move_cursor_to(std::size_t panel, std::size_t column, std::size_t row) const;
+    /// @brief Renders the prompt below the panels, the exit one or the outcome of the round.
+    bool render_prompt(int prompt);
 
-    /// @brief Moves the cursor to the specified GameLocation.
-    void move_cursor_to(const GameLocation &location) const;
+    /// @brief Clears the rows of the log of the wrong guesses.
+    bool clear_feedback();
 
-    /// @brief Moves the cursor to the specified ScreenLocation.
-    void move_cursor_to(const ScreenLocation &location) const;
+    /// @brief Renders the characters typed since the last call.
+    bool render_typed();
 
-    /// @brief Moves the cursor to the specified screen coordinates.
-    void move_cursor_to(int x, int y) const;
+    /// @brief Returns a line of the typed text: the header, then two lines for each wrong guess.
+    /// @param line The index of the line.
+    /// @param buffer Where the line is formatted, if needed, of TYPED_LINE_SIZE characters.
+    /// @param length Receives the length of the line.
+    /// @param x Receives the column of the line.
+    /// @param y Receives the row of the line.
+    /// @return The line, or nullptr past the last one.
+    const char *get_typed_line(std::size_t line, char *buffer, std::size_t &length, int &x, int &y) const;
 
-    /// @brief Loads the dictionary from the specified path.
-    bool load_dictionary();
+    /// @brief Returns the total number of characters to type.
+    std::size_t count_typed() const;
 
-    /// @brief Finds the currently selected word, if any.
-    const Word *find_selected_word() const;
+    /// @brief Shows the rendered frame, with the cursor at the current position.
+    bool present();
+
+    /// @brief Handles input from the user.
+    void parse_input(const InputEvent &event);
+
+    /// @brief Parses mouse input and updates the location accordingly.
+    bool parse_mouse_position(const InputEvent &event, GameLocation &location) const;
+
+    /// @brief Parses keyboard input and updates the location accordingly.
+    bool parse_key_position(int key, GameLocation &location) const;
+
+    /// @brief Computes the memory address for a given row and panel.
+    std::size_t compute_address(std::size_t row, std::size_t panel) const;
 };
 
+/// @brief Game whose layout is given at run time.
+typedef BasicGame<0, 0, 0> Game;
+
+/// @brief Game with the standard layout, 3 panels of 20 rows and 12 columns.
+typedef BasicGame<3, 20, 12> StandardGame;
+
+// The games are compiled once, in game.cpp.
+extern template class BasicGame<0, 0, 0>;
+extern template class BasicGame<3, 20, 12>;
+
 } // namespace robsec
@@ -0,0 +1,83 @@
+/// @file input_log.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Recording and replay of the input of a game.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace robsec
+{
+
+/// @brief An input of the game: a key, or a mouse event with its position.
+struct InputEvent {
+    int key; ///< The key code, as returned by ncurses.
+    int x;   ///< Column of the mouse, only meaningful for KEY_MOUSE.
+    int y;   ///< Row of the mouse, only meaningful for KEY_MOUSE.
+};
+
+/// @brief The configuration of the recorded game, needed to replay it.
+struct RecordingHeader {
+    uint32_t seed;        ///< The seed of the game.
+    uint32_t n_panels;    ///< Number of panels.
+    uint32_t n_rows;      ///< Number of rows per panel.
+    uint32_t n_columns;   ///< Number of columns per panel.
+    uint32_t n_words;     ///< Number of words.
+    int32_t attempts_max; ///< Maximum number of attempts.
+    uint32_t difficulty;  ///< Difficulty of the boards, see `Difficulty`.
+};
+
+/// @brief Writes the input of a game to a file, as it happens.
+/// @details After the header, each event takes a few bytes: the time since
+/// the previous event in microseconds, the key, and the mouse position for
+/// mouse events, all as variable-length integers.
+class InputRecorder {
+private:
+    std::ofstream file;                         ///< The recording.
+    std::chrono::steady_clock::time_point last; ///< Time of the previous event.
+    std::vector<char> buffer;                   ///< The encoded event.
+
+public:
+    /// @brief Constructs a recorder, with no file open.
+    InputRecorder();
+
+    /// @brief Creates the recording and writes its header.
+    /// @return true on success, false otherwise.
+    bool open(const std::string &path, const RecordingHeader &header);
+
+    /// @brief Appends the event to the recording, timestamped now.
+    /// @return true on success, false otherwise.
+    bool record(const InputEvent &event);
+};
+
+/// @brief Reads back the input of a recorded game.
+class InputReplayer {
+private:
+    std::vector<char> data; ///< The whole recording.
+    std::size_t offset;     ///< Position of the next event.
+    RecordingHeader header; ///< The configuration of the game.
+    uint64_t time;          ///< Time of the last event read, in microseconds.
+
+public:
+    /// @brief Constructs a replayer, with no recording loaded.
+    InputReplayer();
+
+    /// @brief Loads the recording.
+    /// @return true on success, false otherwise.
+    bool open(const std::string &path);
+
+    /// @brief Returns the configuration of the recorded game.
+    const RecordingHeader &get_header() const;
+
+    /// @brief Reads the next event.
+    /// @param event Receives the event.
+    /// @param timestamp Receives the time of the event since the start, in microseconds.
+    /// @return true on success, false at the end of the recording or if it is corrupted.
+    bool next(InputEvent &event, uint64_t &timestamp);
+};
+
+} // namespace robsec
@@ -0,0 +1,148 @@
+/// @file layout.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Layout of the panels on the screen, fixed at compile time or given at run time.
+
+#pragma once
+
+#include "robsec/board.hpp"
+
+#include <array>
+#include <vector>
+
+/// @brief Length of an address in the game.
+#define ADDRESS_LEN 6
+
+/// @brief Length of the header in terms of newlines and additional spacing.
+#define HEADER_LEN (3 + 2)
+
+namespace robsec
+{
+
+/// @brief Sizes of the panels, fixed at compile time.
+/// @details The sizes are constant expressions, so the coordinate math below
+/// compiles to multiplications and shifts instead of divisions, and the
+/// addresses fit in a fixed array.
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+class Layout {
+public:
+    /// @brief Storage of the preformatted addresses, row after row and panel after panel.
+    typedef std::array<char, Rows * Panels * (ADDRESS_LEN + 1) + 1> Addresses;
+
+    /// @brief Constructs the layout, the sizes must be the ones of the template, see `matches()`.
+    constexpr Layout(std::size_t, std::size_t, std::size_t)
+    {
+    }
+
+    /// @brief Returns true if the layout has the given sizes.
+    static constexpr bool matches(std::size_t _n_panels, std::size_t _n_rows, std::size_t _n_columns)
+    {
+        return (_n_panels == Panels) && (_n_rows == Rows) && (_n_columns == Columns);
+    }
+
+    /// @brief Returns the number of panels.
+    constexpr std::size_t get_n_panels() const
+    {
+        return Panels;
+    }
+
+    /// @brief Returns the number of rows per panel.
+    constexpr std::size_t get_n_rows() const
+    {
+        return Rows;
+    }
+
+    /// @brief Returns the number of columns per panel.
+    constexpr std::size_t get_n_columns() const
+    {
+        return Columns;
+    }
+};
+
+/// @brief Sizes of the panels, given at run time.
+template <>
+class Layout<0, 0, 0> {
+private:
+    std::size_t n_panels;  ///< Number of panels.
+    std::size_t n_rows;    ///< Number of rows per panel.
+    std::size_t n_columns; ///< Number of columns per panel.
+
+public:
+    /// @brief Storage of the preformatted addresses, row after row and panel after panel.
+    typedef std::vector<char> Addresses;
+
+    /// @brief Constructs the layout with the given sizes.
+    constexpr Layout(std::size_t _n_panels, std::size_t _n_rows, std::size_t _n_columns)
+        : n_panels(_n_panels), n_rows(_n_rows), n_columns(_n_columns)
+    {
+    }
+
+    /// @brief Returns true, the layout takes any size.
+    static constexpr bool matches(std::size_t, std::size_t, std::size_t)
+    {
+        return true;
+    }
+
+    /// @brief Returns the number of panels.
+    constexpr std::size_t get_n_panels() const
+    {
+        return n_panels;
+    }
+
+    /// @brief Returns the number of rows per panel.
+    constexpr std::size_t get_n_rows() const
+    {
+        return n_rows;
+    }
+
+    /// @brief Returns the number of columns per panel.
+    constexpr std::size_t get_n_columns() const
+    {
+        return n_columns;
+    }
+};
+
+/// @brief Returns the width of a panel on the screen, with its address and the spacing.
+template <typename LayoutType>
+constexpr std::size_t panel_width(const LayoutType &layout)
+{
+    return ADDRESS_LEN + 1 + layout.get_n_columns() + 2;
+}
+
+/// @brief Converts a GameLocation to a ScreenLocation.
+template <typename LayoutType>
+constexpr ScreenLocation to_screen_location(const LayoutType &layout, const GameLocation &location)
+{
+    return ScreenLocation((ADDRESS_LEN + 1) * (location.panel + 1) + (2 + layout.get_n_columns()) * location.panel + location.column,
+                          HEADER_LEN + location.row);
+}
+
+/// @brief Converts a ScreenLocation to a GameLocation.
+template <typename LayoutType>
+constexpr GameLocation to_game_location(const LayoutType &layout, const ScreenLocation &location)
+{
+    return GameLocation((location.x - ADDRESS_LEN - 1) / panel_width(layout),
+                        location.x % panel_width(layout) - ADDRESS_LEN - 1, location.y - HEADER_LEN);
+}
+
+/// @brief Converts a linear position inside a panel to a GameLocation.
+template <typename LayoutType>
+constexpr GameLocation linear_to_game_location(const LayoutType &layout, std::size_t panel, std::size_t position)
+{
+    return GameLocation(panel, position % layout.get_n_columns(), position / layout.get_n_columns());
+}
+
+/// @brief Converts a linear position inside a panel to a ScreenLocation.
+template <typename LayoutType>
+constexpr ScreenLocation linear_to_screen_location(const LayoutType &layout, std::size_t panel, std::size_t position)
+{
+    return to_screen_location(layout, linear_to_game_location(layout, panel, position));
+}
+
+/// @brief Returns the offset of the address of a row, from the start address of the board.
+template <typename LayoutType>
+constexpr std::size_t address_offset(const LayoutType &layout, std::size_t row, std::size_t panel)
+{
+    return row * layout.get_n_columns() + panel * layout.get_n_rows() * layout.get_n_columns();
+}
+
+} // namespace robsec
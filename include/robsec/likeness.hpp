@@ -0,0 +1,82 @@
+/// @file likeness.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Likeness between words, i.e., the number of letters they have in common.
+
+#pragma once
+
+#include "robsec/dictionary.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace robsec
+{
+
+/// @brief Counts the number of common letters between two C-style strings.
+///
+/// @param a Pointer to the first string.
+/// @param b Pointer to the second string.
+/// @return The count of common letters between the two strings.
+int count_common_letters(const char *a, const char *b);
+
+/// @brief Histogram of the letters of an uppercase word.
+/// @details Lane `c - 'A' + 1` holds the count of letter `c`, the other lanes
+/// are zero, so that two histograms can be compared 16 lanes at a time.
+struct LetterHistogram {
+    alignas(16) uint8_t counts[32]; ///< Count of each letter.
+    bool letters_only;              ///< If the word contains only the letters A-Z.
+
+    /// @brief Builds the histogram of the given word.
+    LetterHistogram(const char *word, std::size_t length);
+};
+
+/// @brief Counts the number of common letters between the two histograms.
+/// @details Equivalent to `count_common_letters` when both words contain
+/// only uppercase letters, it is the sum of the lane-wise minimum.
+///
+/// @param a The histogram of the first word.
+/// @param b The histogram of the second word.
+/// @return The count of common letters.
+int count_common_letters(const LetterHistogram &a, const LetterHistogram &b);
+
+/// @brief Likeness between every pair of words of a board.
+class LikenessMatrix {
+private:
+    std::size_t size;                        ///< Number of words.
+    std::vector<uint8_t> values;             ///< The likeness, row after row.
+    std::vector<LetterHistogram> histograms; ///< Histograms of the words, kept to reuse their storage.
+
+public:
+    /// @brief Constructs an empty matrix.
+    LikenessMatrix();
+
+    /// @brief Computes the likeness between every pair of the given words.
+    /// @param group The group the words are taken from.
+    /// @param ids The index of each word inside the group.
+    /// @param n_ids The number of words.
+    void build(const DictionaryGroup &group, const uint32_t *ids, std::size_t n_ids);
+
+    /// @brief Removes all the values.
+    void clear();
+
+    /// @brief Returns the number of words.
+    inline std::size_t get_size() const
+    {
+        return size;
+    }
+
+    /// @brief Returns the likeness between the i-th and the j-th word.
+    inline int at(std::size_t i, std::size_t j) const
+    {
+        return values[i * size + j];
+    }
+
+    /// @brief Returns the likeness between the i-th word and all the others.
+    inline const uint8_t *row(std::size_t i) const
+    {
+        return values.data() + i * size;
+    }
+};
+
+} // namespace robsec
@@ -0,0 +1,58 @@
+/// @file likeness_index.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Index of the most alike words of every word in a dictionary.
+
+#pragma once
+
+#include "robsec/dictionary.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace robsec
+{
+
+/// @brief Keeps, for every word of a dictionary, the words of the same group
+/// with the highest likeness, most alike first.
+/// @details Small groups are compared exhaustively. In the large ones the
+/// candidates are found with locality-sensitive hashing: every band hashes
+/// the MinHash of the letter multiset of the words, and only the words
+/// falling in the same bucket of some band are compared.
+class LikenessIndex {
+public:
+    /// @brief Value padding the neighbors of a word which has fewer of them.
+    static const uint32_t no_neighbor;
+
+    /// @brief Number of neighbors to index for each word, for each word of a board.
+    static const std::size_t neighbors_per_board_word;
+
+private:
+    std::size_t n_neighbors;                   ///< Number of neighbors kept for each word.
+    std::vector<std::vector<uint32_t>> groups; ///< For each group, the neighbors of each word, word after word.
+
+public:
+    /// @brief Constructs an empty index.
+    LikenessIndex();
+
+    /// @brief Builds the index of the given dictionary.
+    /// @param dictionary The dictionary, its groups are indexed in the same order.
+    /// @param _n_neighbors The number of neighbors kept for each word.
+    void build(const Dictionary &dictionary, std::size_t _n_neighbors);
+
+    /// @brief Returns the number of neighbors kept for each word.
+    std::size_t get_n_neighbors() const;
+
+    /// @brief Returns the neighbors of a word, most alike first, padded with `no_neighbor`.
+    /// @param group The index of the group of the word, in the dictionary.
+    /// @param word The index of the word inside its group.
+    inline const uint32_t *get_neighbors(std::size_t group, std::size_t word) const
+    {
+        return groups[group].data() + word * n_neighbors;
+    }
+
+private:
+    /// @brief Builds the neighbors of the words of a group.
+    void build_group(const DictionaryGroup &group, std::vector<uint32_t> &neighbors) const;
+};
+
+} // namespace robsec
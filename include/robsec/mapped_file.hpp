@@ -0,0 +1,47 @@
+/// @file mapped_file.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Read-only memory mapping of a file.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace robsec
+{
+
+/// @brief Maps a whole file in memory, read-only.
+/// @details On POSIX systems the file is mapped with mmap, elsewhere it is
+/// read into an owned buffer.
+class MappedFile {
+private:
+    const char *data;         ///< Pointer to the first byte of the file.
+    std::size_t size;         ///< Size of the file in bytes.
+    std::vector<char> buffer; ///< Fallback storage when mmap is not available.
+
+public:
+    /// @brief Constructs an empty mapping.
+    MappedFile();
+
+    /// @brief Unmaps the file, if any.
+    ~MappedFile();
+
+    MappedFile(const MappedFile &)            = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    /// @brief Maps the file at the given path, unmapping the previous one.
+    /// @param path The path to the file.
+    /// @return true if the file was mapped, false otherwise.
+    bool open(const std::string &path);
+
+    /// @brief Unmaps the file.
+    void close();
+
+    /// @brief Returns a pointer to the first byte of the file.
+    const char *get_data() const;
+
+    /// @brief Returns the size of the file in bytes.
+    std::size_t get_size() const;
+};
+
+} // namespace robsec
@@ -0,0 +1,62 @@
+/// @file random.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Random number utilities shared by the game components.
+
+#pragma once
+
+#include <iterator>
+#include <random>
+
+namespace robsec
+{
+
+/// @brief The random engine used by every random choice in the game.
+using RandomEngine = std::mt19937;
+
+/// @brief Generates a random number within the specified range.
+///
+/// @tparam T The type of the range values (e.g., int, std::size_t).
+/// @param engine The random engine used to generate the number.
+/// @param min The minimum value of the range (inclusive).
+/// @param max The maximum value of the range (inclusive).
+/// @return A random number of type T within the specified range.
+template <typename T>
+inline T random_number(RandomEngine &engine, T min, T max)
+{
+    // Uniform distribution for numbers within the given range.
+    std::uniform_int_distribution<T> dist(min, max);
+    return dist(engine); // Generate and return the random number.
+}
+
+/// @brief Selects a random iterator within a specified range, using a custom random generator.
+///
+/// @tparam Iter Type of the iterator.
+/// @tparam RandomGenerator Type of the random generator.
+/// @param start Iterator to the beginning of the range.
+/// @param end Iterator to the end of the range.
+/// @param g Reference to a random generator.
+/// @return A randomly selected iterator within the range.
+template <typename Iter, typename RandomGenerator>
+inline Iter select_randomly(Iter start, Iter end, RandomGenerator &g)
+{
+    using type_t = typename std::iterator_traits<Iter>::difference_type;
+    type_t ub    = std::distance(start, end) - 1;
+    if (ub > 0) {
+        // Create a uniform distribution within the range.
+        std::uniform_int_distribution<type_t> dis(0, ub);
+        // Advance the start iterator by a random offset.
+        std::advance(start, dis(g));
+    }
+    return start; // Return the randomly selected iterator.
+}
+
+/// @brief Returns the given seed, or a non-deterministic one if it is zero.
+///
+/// @param seed The requested seed.
+/// @return The seed to use for the random engine.
+inline unsigned resolve_seed(unsigned seed)
+{
+    return seed ? seed : std::random_device{}();
+}
+
+} // namespace robsec
@@ -0,0 +1,150 @@
+/// @file render_target.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Targets the game can be rendered to.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace robsec
+{
+
+/// @brief Attributes of the rendered text.
+enum TextAttribute {
+    Normal,      ///< Default colors.
+    Highlighted, ///< Yellow text, used for the words.
+    Reversed,    ///< Reverse video, used for the selected word.
+};
+
+/// @brief Grid of characters the game is rendered to.
+/// @details Text is written at the current position, which advances after
+/// each character. Nothing is shown until `present()` is called.
+class RenderTarget {
+public:
+    /// @brief Destroys the target.
+    virtual ~RenderTarget();
+
+    /// @brief Prepares the target for rendering.
+    /// @return true on success, false otherwise.
+    virtual bool start() = 0;
+
+    /// @brief Releases the resources of the target.
+    virtual void stop() = 0;
+
+    /// @brief Returns the number of columns of the target.
+    virtual int get_width() const = 0;
+
+    /// @brief Returns the number of rows of the target.
+    virtual int get_height() const = 0;
+
+    /// @brief Moves the current position.
+    /// @return true on success, false if the position is outside the target.
+    virtual bool move(int x, int y) = 0;
+
+    /// @brief Writes the text at the current position.
+    /// @param text The characters to write.
+    /// @param length The number of characters to write.
+    /// @param attribute The attribute of the text.
+    /// @return true on success, false otherwise.
+    virtual bool write(const char *text, std::size_t length, TextAttribute attribute) = 0;
+
+    /// @brief Clears the current row, from the current position to its end.
+    /// @return true on success, false otherwise.
+    virtual bool clear_to_end_of_line() = 0;
+
+    /// @brief Shows what has been written, leaving the cursor at the given position.
+    /// @return true on success, false otherwise.
+    virtual bool present(int cursor_x, int cursor_y) = 0;
+};
+
+/// @brief Renders to the ncurses standard screen.
+class CursesRenderTarget : public RenderTarget {
+public:
+    /// @brief Constructs the target, without initializing ncurses.
+    CursesRenderTarget();
+
+    bool start() override;
+    void stop() override;
+    int get_width() const override;
+    int get_height() const override;
+    bool move(int x, int y) override;
+    bool write(const char *text, std::size_t length, TextAttribute attribute) override;
+    bool clear_to_end_of_line() override;
+    bool present(int cursor_x, int cursor_y) override;
+};
+
+/// @brief Renders to an in-memory grid of characters and attributes.
+/// @details On `present()` the grid is compared to the previously presented
+/// one, and only the changed cells are emitted, as ANSI escape sequences,
+/// into an output buffer.
+class FrameBufferRenderTarget : public RenderTarget {
+private:
+    /// @brief A cell of the grid.
+    struct Cell {
+        char character;    ///< The character of the cell.
+        uint8_t attribute; ///< The attribute of the cell.
+
+        bool operator==(const Cell &rhs) const
+        {
+            return (character == rhs.character) && (attribute == rhs.attribute);
+        }
+    };
+
+    int width;                ///< Number of columns.
+    int height;               ///< Number of rows.
+    int x;                    ///< Current column.
+    int y;                    ///< Current row.
+    std::vector<Cell> back;   ///< The grid being written.
+    std::vector<Cell> front;  ///< The grid that was last presented.
+    std::string output;       ///< The ANSI output not yet consumed.
+    bool cleared;             ///< If the terminal has been cleared.
+
+public:
+    /// @brief Constructs a blank grid of the given size.
+    FrameBufferRenderTarget(int _width, int _height);
+
+    bool start() override;
+    void stop() override;
+    int get_width() const override;
+    int get_height() const override;
+    bool move(int _x, int _y) override;
+    bool write(const char *text, std::size_t length, TextAttribute attribute) override;
+    bool clear_to_end_of_line() override;
+    bool present(int cursor_x, int cursor_y) override;
+
+    /// @brief Returns the character at the given cell, as presented last.
+    char get_character(int _x, int _y) const;
+
+    /// @brief Returns the ANSI output produced by the presents so far.
+    const std::string &get_output() const;
+
+    /// @brief Appends raw text to the output, after what was presented.
+    void append_output(const char *text);
+
+    /// @brief Discards the ANSI output produced so far, keeping its capacity.
+    void clear_output();
+};
+
+/// @brief Discards everything, for the hosts which draw the board themselves.
+class NullRenderTarget : public RenderTarget {
+private:
+    int width;  ///< Number of columns.
+    int height; ///< Number of rows.
+
+public:
+    /// @brief Constructs a target of the given size.
+    NullRenderTarget(int _width, int _height);
+
+    bool start() override;
+    void stop() override;
+    int get_width() const override;
+    int get_height() const override;
+    bool move(int _x, int _y) override;
+    bool write(const char *text, std::size_t length, TextAttribute attribute) override;
+    bool clear_to_end_of_line() override;
+    bool present(int cursor_x, int cursor_y) override;
+};
+
+} // namespace robsec
@@ -0,0 +1,149 @@
+/// @file robsec.h
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief C interface of the game, to embed it in a host application.
+/// @details The host creates games from a shared dictionary, feeds them the
+/// input and reads the board through a view, whose pointers refer to the
+/// buffers of the game itself: nothing is copied, and nothing is rendered,
+/// the host draws the board as it likes. The functions are not thread-safe
+/// for the same game, different games can be used from different threads.
+
+#ifndef ROBSEC_ROBSEC_H
+#define ROBSEC_ROBSEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @brief A dictionary, shared by all the games created from it.
+typedef struct robsec_dictionary robsec_dictionary;
+
+/// @brief A game, which plays a round after the other.
+typedef struct robsec_game robsec_game;
+
+/// @brief The keys understood by the game, besides 'h' (move to the hint) and 'r' (new round, once over).
+/// @details Enter on the opening bracket of a pair removes a dud, or now and
+/// then replenishes the attempts.
+enum robsec_key {
+    ROBSEC_KEY_ENTER = 10,    ///< Guess the selected word.
+    ROBSEC_KEY_UP    = 0x101, ///< Move the cursor up.
+    ROBSEC_KEY_DOWN  = 0x102, ///< Move the cursor down.
+    ROBSEC_KEY_LEFT  = 0x103, ///< Move the cursor left, to the previous panel at the first column.
+    ROBSEC_KEY_RIGHT = 0x104  ///< Move the cursor right, to the next panel at the last column.
+};
+
+/// @brief The state of the round.
+enum robsec_state {
+    ROBSEC_RUNNING = 0, ///< The round goes on.
+    ROBSEC_WON     = 1, ///< The solution was guessed.
+    ROBSEC_LOST    = 2  ///< The attempts ran out.
+};
+
+/// @brief The configuration of a game.
+typedef struct robsec_config {
+    size_t n_panels;  ///< Number of panels.
+    size_t n_rows;    ///< Number of rows per panel.
+    size_t n_columns; ///< Number of columns per panel.
+    size_t n_words;   ///< Number of words.
+    int attempts_max; ///< Maximum number of attempts.
+    unsigned seed;    ///< Seed of the boards, 0 for a random one.
+} robsec_config;
+
+/// @brief The result of a wrong guess.
+typedef struct robsec_feedback {
+    size_t word;  ///< Index of the guessed word.
+    int likeness; ///< Number of letters in common with the solution.
+} robsec_feedback;
+
+/// @brief Read-only view of the current round.
+/// @details The pointers refer to the buffers of the game and of the
+/// dictionary, they are valid until the next input or round.
+typedef struct robsec_board_view {
+    size_t n_panels;                 ///< Number of panels.
+    size_t n_rows;                   ///< Number of rows per panel.
+    size_t n_columns;                ///< Number of columns per panel.
+    const char *content;             ///< The garbage of the panels, panel after panel and row after row, the words are drawn over it.
+    const uint32_t *cells;           ///< For each character of `content`, the word covering it, or UINT32_MAX.
+    const uint32_t *pairs;           ///< For each character of `content`, the length of the bracket pair it opens, or 0.
+    size_t start_address;            ///< The address of the first character of the first panel.
+    size_t n_words;                  ///< Number of words.
+    size_t word_length;              ///< Length shared by all the words.
+    const char *words;               ///< The words of the dictionary with that length, each one followed by a null terminator.
+    const uint32_t *word_ids;        ///< For each word, its index in `words`, it starts at `words + id * (word_length + 1)`.
+    const uint32_t *word_panels;     ///< For each word, the panel it is placed in.
+    const uint32_t *word_starts;     ///< For each word, the position of its first character in its panel.
+    const uint8_t *likeness;         ///< The likeness between every pair of words, `n_words` rows of `n_words` values.
+    const robsec_feedback *feedback; ///< The wrong guesses, in order.
+    size_t n_feedback;               ///< Number of wrong guesses.
+    size_t cursor_panel;             ///< Panel of the cursor.
+    size_t cursor_row;               ///< Row of the cursor.
+    size_t cursor_column;            ///< Column of the cursor.
+    uint32_t selected_word;          ///< The word under the cursor, or UINT32_MAX.
+    int attempts;                    ///< Remaining number of attempts.
+    int attempts_max;                ///< Maximum number of attempts.
+    int state;                       ///< The state of the round, see `robsec_state`.
+} robsec_board_view;
+
+/// @brief Returns the merge of the given dictionaries, loading it if it is not shared yet.
+/// @param paths The comma-separated list of dictionary files and directories.
+/// @param deduplicate Non-zero to keep the repeated words only once.
+/// @return The dictionary, or NULL if it fails to load.
+robsec_dictionary *robsec_dictionary_acquire(const char *paths, int deduplicate);
+
+/// @brief Releases a dictionary, the games created from it keep it alive.
+void robsec_dictionary_release(robsec_dictionary *dictionary);
+
+/// @brief Creates a game, and generates its first board.
+/// @param dictionary The dictionary the words are taken from.
+/// @param config The configuration of the game.
+/// @return The game, or NULL on failure.
+robsec_game *robsec_game_create(const robsec_dictionary *dictionary, const robsec_config *config);
+
+/// @brief Destroys a game.
+void robsec_game_destroy(robsec_game *game);
+
+/// @brief Feeds a key to the game.
+/// @param game The game.
+/// @param key A `robsec_key`, 'h' or 'r'.
+/// @return Non-zero if the round goes on, zero if it is over or the game is NULL.
+int robsec_game_key(robsec_game *game, int key);
+
+/// @brief Moves the cursor to a cell, and guesses the word covering it, as for a mouse click.
+/// @param game The game.
+/// @param panel The panel of the cell.
+/// @param row The row of the cell.
+/// @param column The column of the cell.
+/// @return Non-zero if the round goes on, zero if it is over, the game is NULL or the cell is outside of the board.
+int robsec_game_click(robsec_game *game, size_t panel, size_t row, size_t column);
+
+/// @brief Starts a new round on a new board.
+/// @param game The game.
+/// @return Non-zero on success, zero otherwise.
+int robsec_game_new_round(robsec_game *game);
+
+/// @brief Saves the current round, to resume it later or in another process.
+/// @param game The game.
+/// @param buffer Where the snapshot is written, or NULL to get its size.
+/// @param size The size of the buffer.
+/// @return The size of the snapshot, which is written only if it fits, or 0 on failure.
+size_t robsec_game_save(robsec_game *game, char *buffer, size_t size);
+
+/// @brief Resumes a saved round, on a game with the same layout and dictionary.
+/// @param game The game.
+/// @param data The snapshot.
+/// @param size The size of the snapshot.
+/// @return Non-zero on success, zero otherwise, then the game keeps its round.
+int robsec_game_load(robsec_game *game, const char *data, size_t size);
+
+/// @brief Fills the view of the current round, unless the game or the view is NULL.
+/// @param game The game.
+/// @param view The view to fill.
+void robsec_game_view(const robsec_game *game, robsec_board_view *view);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ROBSEC_ROBSEC_H
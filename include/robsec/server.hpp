@@ -0,0 +1,107 @@
+/// @file server.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Server hosting many games over telnet, in a single process.
+
+#pragma once
+
+#include "robsec/dictionary.hpp"
+#include "robsec/game.hpp"
+#include "robsec/render_target.hpp"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+
+namespace robsec
+{
+
+/// @brief Hosts independent games for the clients connected over telnet.
+/// @details All the sessions share the same dictionary and are served by a
+/// single thread, with a non-blocking epoll event loop. Each session renders
+/// to a framebuffer, whose ANSI output is sent to the client. The animations
+/// of all the sessions share a single periodic timer, armed only while some
+/// game is animating, so that idle sessions cost nothing.
+class Server {
+private:
+    /// @brief A connected client, with its own game.
+    struct Session {
+        int fd;                         ///< The socket of the client.
+        FrameBufferRenderTarget target; ///< The screen of the client.
+        Game game;                      ///< The game of the client.
+        std::size_t sent;               ///< Bytes of the target output already sent.
+        bool closing;                   ///< If the session ends once the output is sent.
+        bool writable;                  ///< If the socket is polled for writing.
+        int telnet;                     ///< State of the telnet command being parsed.
+        int escape;                     ///< State of the ANSI escape sequence being parsed.
+        bool carriage_return;           ///< If the previous character was a carriage return.
+
+        Session(int _fd, const ScreenLocation &size, const std::shared_ptr<const Dictionary> &dictionary, std::size_t n_panels, std::size_t n_rows, std::size_t n_columns, std::size_t n_words, int attempts_max, unsigned seed, BoardPrefetcher *prefetcher);
+    };
+
+    std::shared_ptr<const Dictionary> dictionary;      ///< The dictionary shared by all the games.
+    std::size_t n_panels;                              ///< Number of panels in each game.
+    std::size_t n_rows;                                ///< Number of rows per panel.
+    std::size_t n_columns;                             ///< Number of columns per panel.
+    std::size_t n_words;                               ///< Number of words in each game.
+    int attempts_max;                                  ///< Maximum number of allowed attempts.
+    unsigned seed;                                     ///< Seed of the first game (0 for random ones).
+    BoardPrefetcher *prefetcher;                       ///< Source of ready boards for all the sessions, if any.
+    const LikenessIndex *index;                        ///< The likeness index of the dictionary, if the difficulty is rated.
+    Difficulty difficulty;                             ///< The difficulty of the boards of every session.
+    bool animated;                                     ///< If the games type the header and the feedback.
+    std::size_t n_sessions;                            ///< Number of sessions started so far.
+    int listener;                                      ///< The listening socket.
+    int poller;                                        ///< The epoll instance.
+    int ticker;                                        ///< The timer of the animations.
+    std::map<int, std::unique_ptr<Session> > sessions; ///< The connected clients, by socket.
+    std::set<int> animating;                           ///< The sessions whose game is animating, by socket.
+
+public:
+    /// @brief Constructs the server, the games are configured as in the interactive mode.
+    /// @details When the seed is not zero, the n-th session uses seed + n.
+    /// When a prefetcher is given, all the sessions take their boards from it.
+    Server(std::shared_ptr<const Dictionary> _dictionary, std::size_t _n_panels, std::size_t _n_rows, std::size_t _n_columns, std::size_t _n_words, int _attempts_max, unsigned _seed, BoardPrefetcher *_prefetcher);
+
+    /// @brief Closes all the sessions and the sockets.
+    ~Server();
+
+    /// @brief Sets the difficulty of the boards of the next sessions.
+    /// @param _index The likeness index of the dictionary, which must outlive the server.
+    /// @param _difficulty The difficulty, `Unrated` picks the words at random.
+    void set_difficulty(const LikenessIndex *_index, Difficulty _difficulty);
+
+    /// @brief Animates the games of the next sessions, see `Game::set_animated()`.
+    void set_animated(bool _animated);
+
+    /// @brief Serves the clients until the process is interrupted.
+    /// @param port The TCP port to listen on.
+    /// @return true if the server stopped because it was interrupted, false on error.
+    bool serve(uint16_t port);
+
+private:
+    /// @brief Accepts all the pending connections.
+    void accept_clients();
+
+    /// @brief Reads and handles the input of the session.
+    void receive(Session &session);
+
+    /// @brief Sends the pending output of the session, closing it if it ended.
+    void send(Session &session);
+
+    /// @brief Ticks the animation of the session until it ends, if it is animating.
+    void schedule(Session &session);
+
+    /// @brief Advances the animations of the sessions by the elapsed ticks.
+    void tick();
+
+    /// @brief Decodes a byte received from the client into a key for the game.
+    /// @return The key, or -1 if the byte does not complete one.
+    int decode(Session &session, unsigned char byte) const;
+
+    /// @brief Closes the session and forgets about it.
+    void close(int fd);
+};
+
+} // namespace robsec
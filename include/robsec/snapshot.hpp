@@ -0,0 +1,37 @@
+/// @file snapshot.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Compact binary snapshots of the boards, to save, migrate and resume rounds.
+
+#pragma once
+
+#include "robsec/board.hpp"
+#include "robsec/dictionary.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace robsec
+{
+
+/// @brief Appends the snapshot of a board, after a versioned header.
+/// @details The words are stored as their ids in the dictionary group, and
+/// each cell of the content as a 5-bit index in the garbage alphabet, see
+/// `Board::garbage`. The removed words and the bracket pairs still usable
+/// are kept too, while the tables rebuilt from them, such as the likeness,
+/// are not stored.
+/// @param dictionary The dictionary the words of the board come from.
+/// @param board The board.
+/// @param buffer Where the snapshot is appended.
+/// @return true on success, false if the board is not made of the dictionary and of the garbage alphabet.
+bool serialize_board(const Dictionary &dictionary, const Board &board, std::vector<char> &buffer);
+
+/// @brief Reads the snapshot of a board, rebuilding its tables.
+/// @param dictionary The dictionary of the snapshot, the same one it was saved with.
+/// @param data The snapshot.
+/// @param size The size of the snapshot.
+/// @param offset The position of the snapshot, moved past it.
+/// @param board Receives the board.
+/// @return true on success, false if the snapshot is corrupted or does not match the dictionary.
+bool deserialize_board(const Dictionary &dictionary, const char *data, std::size_t size, std::size_t &offset, Board &board);
+
+} // namespace robsec
@@ -0,0 +1,58 @@
+/// @file solver.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Solver which narrows down the possible solutions of a board.
+
+#pragma once
+
+#include "robsec/likeness.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace robsec
+{
+
+/// @brief Keeps the words that can still be the solution, and suggests the
+/// guess that eliminates the most of them.
+/// @details The candidates are a bitset over the words of the board, and the
+/// likeness is read from the precomputed matrix of the board.
+class Solver {
+private:
+    const LikenessMatrix *likeness;           ///< Likeness between the words of the board.
+    std::vector<uint64_t> candidates;         ///< One bit for each word that can still be the solution.
+    std::vector<uint64_t> guesses;            ///< One bit for each word that can still be guessed.
+    std::size_t remaining;                    ///< Number of candidates.
+    mutable std::vector<std::size_t> buckets; ///< Scratch space used to rank the guesses.
+
+public:
+    /// @brief Constructs a solver without a board.
+    Solver();
+
+    /// @brief Starts solving a new board, where every word is a candidate.
+    /// @param _likeness The likeness matrix of the board, which must outlive the solver.
+    void reset(const LikenessMatrix &_likeness);
+
+    /// @brief Narrows the candidates with the feedback of a wrong guess.
+    /// @param guess The index of the guessed word.
+    /// @param common_letters The letters the guess has in common with the solution.
+    void observe(std::size_t guess, int common_letters);
+
+    /// @brief Removes a word known not to be the solution, which cannot be guessed anymore.
+    /// @param word The index of the word.
+    void remove(std::size_t word);
+
+    /// @brief Checks if the given word can still be the solution.
+    bool is_candidate(std::size_t word) const;
+
+    /// @brief Returns the number of words that can still be the solution.
+    std::size_t get_remaining() const;
+
+    /// @brief Returns the guess which minimizes the worst-case number of candidates left.
+    /// @details Only the words which were not removed are considered.
+    /// @details Ties are broken by preferring candidates, which can win right
+    /// away, and then by the smallest expected number of candidates left.
+    /// @return The index of the suggested word.
+    std::size_t best_guess() const;
+};
+
+} // namespace robsec
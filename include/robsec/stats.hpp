@@ -0,0 +1,90 @@
+/// @file stats.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Statistics about the frames and the initialization of a game.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+namespace robsec
+{
+
+/// @brief Histogram of non-negative values, with fixed-size storage.
+/// @details Values below 16 have their own bucket, larger ones fall in one of
+/// eight buckets for each power of two, so that percentiles are accurate
+/// within 12.5%. Recording a value is constant time and never allocates.
+class Histogram {
+private:
+    /// @brief Number of buckets: 16 exact ones, then 8 for each power of two from 2^4 to 2^63.
+    static const std::size_t n_buckets = 16 + 60 * 8;
+
+    uint64_t counts[n_buckets]; ///< The number of values in each bucket.
+    uint64_t count;             ///< The number of values.
+    uint64_t max;               ///< The largest value.
+    uint64_t sum;               ///< The sum of the values.
+
+public:
+    /// @brief Constructs an empty histogram.
+    Histogram();
+
+    /// @brief Adds a value to the histogram.
+    void record(uint64_t value);
+
+    /// @brief Returns the number of values recorded.
+    uint64_t get_count() const;
+
+    /// @brief Returns the largest value recorded.
+    uint64_t get_max() const;
+
+    /// @brief Returns the mean of the values recorded.
+    double get_mean() const;
+
+    /// @brief Returns the value below which the given fraction of the values falls.
+    /// @param fraction The fraction, between 0 and 1 (e.g., 0.99 for p99).
+    uint64_t get_percentile(double fraction) const;
+};
+
+/// @brief Durations of the phases of the initialization, in seconds.
+struct GenerationTimings {
+    double placement; ///< Placing the words on the panels.
+    double garbage;   ///< Filling the panels with garbage.
+    double likeness;  ///< Computing the likeness between the words.
+};
+
+/// @brief Statistics collected while playing.
+struct GameStats {
+    double dictionary_load;       ///< Seconds spent loading the dictionary.
+    double index_build;           ///< Seconds spent building the likeness index, for a rated difficulty.
+    GenerationTimings generation; ///< Seconds spent generating the first board.
+    double target_start;          ///< Seconds spent starting the render target (e.g., ncurses).
+    double first_frame;           ///< Seconds spent rendering the first frame.
+    Histogram input_latency;      ///< Nanoseconds from reading an input to presenting its frame.
+    Histogram render_time;        ///< Nanoseconds spent rendering each frame.
+    Histogram present_time;       ///< Nanoseconds spent presenting each frame (e.g., refresh()).
+    Histogram frame_allocations;  ///< Allocations done while painting each frame.
+
+    /// @brief Constructs empty statistics.
+    GameStats();
+
+    /// @brief Writes the statistics as plain text.
+    void write_text(std::ostream &out) const;
+
+    /// @brief Writes the statistics as a JSON object.
+    void write_json(std::ostream &out) const;
+};
+
+/// @brief Returns the nanoseconds elapsed between two time points.
+inline uint64_t elapsed_ns(std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end)
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+}
+
+/// @brief Returns the seconds elapsed between two time points.
+inline double elapsed_s(std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end)
+{
+    return std::chrono::duration<double>(end - begin).count();
+}
+
+} // namespace robsec
@@ -0,0 +1,75 @@
+/// @file thread_pool.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Work-stealing pool of threads.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace robsec
+{
+
+/// @brief Pool of threads, each with its own queue of tasks.
+/// @details A worker takes the most recent task from its own queue, and when
+/// it is empty it steals the oldest task from the queue of another worker.
+class ThreadPool {
+public:
+    /// @brief A unit of work.
+    using Task = std::function<void()>;
+
+private:
+    /// @brief The queue of a worker.
+    struct Queue {
+        std::mutex mutex;       ///< Protects the tasks.
+        std::deque<Task> tasks;  ///< The tasks of the worker.
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues; ///< One queue for each worker.
+    std::vector<std::thread> workers;           ///< The worker threads.
+    std::mutex mutex;                           ///< Protects the waiting on the condition variables.
+    std::condition_variable work_available;     ///< Signaled when a task is submitted, or on stop.
+    std::condition_variable work_done;          ///< Signaled when all the tasks are completed.
+    std::atomic<std::size_t> queued;            ///< Number of tasks waiting in the queues.
+    std::atomic<std::size_t> pending;           ///< Number of tasks submitted and not yet completed.
+    std::atomic<std::size_t> next;              ///< Queue which receives the next submitted task.
+    bool stopping;                              ///< If the workers must stop.
+
+public:
+    /// @brief Starts the given number of workers.
+    /// @param n_threads The number of workers, 0 for one per hardware thread.
+    explicit ThreadPool(std::size_t n_threads);
+
+    /// @brief Completes the pending tasks, and stops the workers.
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &)            = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /// @brief Returns the number of workers.
+    std::size_t get_size() const;
+
+    /// @brief Submits a task, spreading the tasks over the workers' queues.
+    void submit(Task task);
+
+    /// @brief Waits until all the submitted tasks are completed.
+    void wait();
+
+private:
+    /// @brief The loop of each worker.
+    void work(std::size_t index);
+
+    /// @brief Takes the most recent task of the given queue.
+    bool pop(std::size_t index, Task &task);
+
+    /// @brief Takes the oldest task of any queue other than the given one.
+    bool steal(std::size_t index, Task &task);
+};
+
+} // namespace robsec
@@ -0,0 +1,55 @@
+/// @file varint.hpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Variable-length integers, shared by the binary formats.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace robsec
+{
+
+/// @brief Appends a variable-length unsigned integer, seven bits per byte.
+inline void write_varint(std::vector<char> &buffer, uint64_t value)
+{
+    while (value >= 0x80) {
+        buffer.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    buffer.push_back(static_cast<char>(value));
+}
+
+/// @brief Reads a variable-length unsigned integer.
+/// @param data The encoded data.
+/// @param size The size of the data.
+/// @param offset The position of the integer, moved past it.
+/// @param value Receives the integer.
+/// @return true on success, false if the data ends before the integer.
+inline bool read_varint(const char *data, std::size_t size, std::size_t &offset, uint64_t &value)
+{
+    value = 0;
+    for (unsigned shift = 0; (offset < size) && (shift < 64); shift += 7) {
+        uint8_t byte = static_cast<uint8_t>(data[offset++]);
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/// @brief Maps a signed integer to an unsigned one, keeping small values small.
+inline uint64_t zigzag_encode(int64_t value)
+{
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+/// @brief Inverse of zigzag_encode().
+inline int64_t zigzag_decode(uint64_t value)
+{
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+} // namespace robsec
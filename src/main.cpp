@@ -1,39 +1,446 @@
+#include "robsec/allocation_counter.hpp"
+#include "robsec/board.hpp"
+#include "robsec/board_prefetcher.hpp"
+#include "robsec/dictionary.hpp"
+#include "robsec/dictionary_cache.hpp"
 #include "robsec/game.hpp"
+#include "robsec/input_log.hpp"
+#include "robsec/likeness_index.hpp"
+#include "robsec/stats.hpp"
+#include "robsec/server.hpp"
 
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <thread>
 
 #include <cmdlp/parser.hpp>
+
 #include <ncurses.h>
 
+/// @brief Generates the given number of boards, without initializing the display.
+///
+/// @param dictionary_paths The comma-separated paths to the dictionaries.
+/// @param deduplicate If the repeated words must be kept only once.
+/// @param n_panels The number of panels.
+/// @param n_rows The number of rows.
+/// @param n_columns The number of columns.
+/// @param n_words The number of words.
+/// @param difficulty The difficulty of the boards.
+/// @param seed The seed of the random engine (0 for a random one).
+/// @param n_boards The number of boards to generate.
+/// @param output_path The path where the boards are written (empty for stdout).
+/// @return 0 on success, 1 otherwise.
+static int generate_boards(const std::string &dictionary_paths,
+                           bool deduplicate,
+                           std::size_t n_panels,
+                           std::size_t n_rows,
+                           std::size_t n_columns,
+                           std::size_t n_words,
+                           robsec::Difficulty difficulty,
+                           unsigned seed,
+                           std::size_t n_boards,
+                           const std::string &output_path)
+{
+    // Load the dictionary.
+    std::vector<std::string> files;
+    robsec::Dictionary dictionary;
+    if (!robsec::Dictionary::list_files(dictionary_paths, files) || !dictionary.load(files, 0, deduplicate)) {
+        std::cerr << "Error: Failed to load the dictionary." << std::endl;
+        return 1;
+    }
+
+    // Open the output file, if requested.
+    std::ofstream file;
+    if (!output_path.empty()) {
+        file.open(output_path);
+        if (!file.is_open()) {
+            std::cerr << "Error: Failed to open the output file: " << output_path << std::endl;
+            return 1;
+        }
+    }
+    std::ostream &out = output_path.empty() ? std::cout : file;
+
+    // Index the likeness of the words, if the difficulty is rated.
+    robsec::LikenessIndex index;
+    if (difficulty != robsec::Unrated) {
+        index.build(dictionary, robsec::LikenessIndex::neighbors_per_board_word * n_words);
+    }
+
+    robsec::BoardGenerator generator(dictionary, n_panels, n_rows, n_columns, n_words);
+    generator.set_difficulty(&index, difficulty);
+    robsec::RandomEngine engine(robsec::resolve_seed(seed));
+    robsec::Board board;
+
+    auto begin = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < n_boards; ++i) {
+        if (!generator.generate(board, engine)) {
+            std::cerr << "Error: Failed to generate board " << i << "." << std::endl;
+            return 1;
+        }
+        out << "BOARD " << i << "\n"
+            << board << "\n";
+    }
+    out.flush();
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    std::cerr << "Generated " << n_boards << " boards in " << elapsed << " s ("
+              << (elapsed > 0 ? static_cast<double>(n_boards) / elapsed : 0.0) << " boards/s)" << std::endl;
+    return 0;
+}
+
+/// @brief Writes the statistics to the standard output, if they were collected.
+///
+/// @param stats The statistics, null if they were not collected.
+/// @param format Either "text" or "json".
+static void write_stats(const robsec::GameStats *stats, const std::string &format)
+{
+    if (!stats) {
+        return;
+    }
+    std::fflush(stdout);
+    if (format == "json") {
+        stats->write_json(std::cout);
+    } else {
+        stats->write_text(std::cout);
+    }
+    std::cout.flush();
+}
+
+/// @brief Feeds the recorded inputs to a game, hashing what it renders.
+///
+/// @tparam GameType The game, with a fixed layout or not.
+/// @param game The game, matching the recording.
+/// @param target The target the game renders to.
+/// @param replayer The replayer of the recording.
+/// @param factor The factor of the recorded pace, 0 for as fast as possible.
+/// @param stats If not null, receives the statistics of the replay.
+/// @return 0 if the replayed game was won, 1 otherwise.
+template <typename GameType>
+static int replay_events(GameType &game,
+                         robsec::FrameBufferRenderTarget &target,
+                         robsec::InputReplayer &replayer,
+                         double factor,
+                         robsec::GameStats *stats)
+{
+    game.set_stats(stats);
+    if (!game.initialize()) {
+        return 1;
+    }
+
+    // Hash the output, so that two replays can be compared (FNV-1a).
+    uint64_t hash        = 14695981039346656037ULL;
+    std::size_t n_bytes  = 0;
+    std::size_t n_events = 0;
+    auto consume         = [&]() {
+        for (char c : target.get_output()) {
+            hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ULL;
+        }
+        n_bytes += target.get_output().size();
+        target.clear_output();
+    };
+    consume();
+
+    robsec::InputEvent event;
+    uint64_t timestamp;
+    auto begin = std::chrono::steady_clock::now();
+    while (replayer.next(event, timestamp)) {
+        if (factor > 0) {
+            std::this_thread::sleep_until(begin + std::chrono::microseconds(static_cast<long long>(static_cast<double>(timestamp) / factor)));
+        }
+        auto arrival = std::chrono::steady_clock::now();
+        game.handle_input(&event, 1);
+        if (stats) {
+            stats->input_latency.record(robsec::elapsed_ns(arrival, std::chrono::steady_clock::now()));
+        }
+        consume();
+        ++n_events;
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    std::cerr << "Replayed " << n_events << " events in " << elapsed << " s ("
+              << (elapsed > 0 ? static_cast<double>(n_events) / elapsed : 0.0) << " events/s), "
+              << n_bytes << " bytes of output, hash " << std::hex << hash << std::dec << std::endl;
+    if (game.has_won()) {
+        printf("Terminal unlocked\n");
+        return 0;
+    }
+    printf("Terminal locked\n");
+    return 1;
+}
+
+/// @brief Replays a recorded game on a framebuffer, without a terminal.
+///
+/// @param dictionary The dictionary of the recorded game.
+/// @param path The path to the recording.
+/// @param speed The speed of the replay, "max" for as fast as possible or a
+/// factor of the recorded pace (1 for real time).
+/// @param stats If not null, receives the statistics of the replay.
+/// @return 0 if the replayed game was won, 1 otherwise.
+static int replay_game(const std::shared_ptr<const robsec::Dictionary> &dictionary,
+                       const std::string &path,
+                       const std::string &speed,
+                       robsec::GameStats *stats)
+{
+    robsec::InputReplayer replayer;
+    if (!replayer.open(path)) {
+        return 1;
+    }
+    double factor = (speed == "max") ? 0.0 : std::atof(speed.c_str());
+    if ((speed != "max") && (factor <= 0)) {
+        std::cerr << "Error: The speed must be 'max' or a positive factor: " << speed << std::endl;
+        return 1;
+    }
+
+    // Index the likeness of the words, if the recorded difficulty is rated.
+    const robsec::RecordingHeader &header = replayer.get_header();
+    if (header.difficulty > robsec::Hard) {
+        std::cerr << "Error: Unknown difficulty " << header.difficulty << " in the recording: " << path << std::endl;
+        return 1;
+    }
+    robsec::Difficulty difficulty = static_cast<robsec::Difficulty>(header.difficulty);
+    robsec::LikenessIndex index;
+    if (difficulty != robsec::Unrated) {
+        auto begin = std::chrono::steady_clock::now();
+        index.build(*dictionary, robsec::LikenessIndex::neighbors_per_board_word * header.n_words);
+        if (stats) {
+            stats->index_build = robsec::elapsed_s(begin, std::chrono::steady_clock::now());
+        }
+    }
+
+    // Play the recorded game on a screen of the right size, with the
+    // specialized game if the layout is the standard one.
+    robsec::ScreenLocation size           = robsec::Game::get_screen_size(header.n_panels, header.n_rows, header.n_columns, header.attempts_max);
+    robsec::FrameBufferRenderTarget target(static_cast<int>(size.x), static_cast<int>(size.y));
+    if (robsec::StandardGame::matches(header.n_panels, header.n_rows, header.n_columns)) {
+        robsec::StandardGame game(target, dictionary, header.n_panels, header.n_rows, header.n_columns, header.n_words, header.attempts_max, header.seed, nullptr);
+        game.set_difficulty(&index, difficulty);
+        return replay_events(game, target, replayer, factor, stats);
+    }
+    robsec::Game game(target, dictionary, header.n_panels, header.n_rows, header.n_columns, header.n_words, header.attempts_max, header.seed, nullptr);
+    game.set_difficulty(&index, difficulty);
+    return replay_events(game, target, replayer, factor, stats);
+}
+
+/// @brief Plays a game on the terminal, until the user quits.
+///
+/// @tparam GameType The game, with a fixed layout or not.
+/// @param game The game to play.
+/// @param coalesce If true, a single frame is rendered for each burst of keys.
+/// @param recorder If not null, it records every input.
+/// @param stats If not null, receives the statistics of the game.
+/// @param won Receives true if the game was won.
+/// @return true if the game could be played, false otherwise.
+template <typename GameType>
+static bool play_game(GameType &game, bool coalesce, robsec::InputRecorder *recorder, robsec::GameStats *stats, bool &won)
+{
+    game.set_stats(stats);
+    if (!game.initialize()) {
+        return false;
+    }
+    won = game.run(coalesce, recorder);
+    game.stop();
+
+    if (robsec::counting_allocations()) {
+        printf("Maximum allocations per frame: %zu\n", game.get_max_frame_allocations());
+    }
+    return true;
+}
+
 int main(int argc, char *argv[])
 {
+    // Compile a dictionary: robsec --compile-dictionary in.txt out.bin
+    if ((argc > 1) && (std::string(argv[1]) == "--compile-dictionary")) {
+        if (argc != 4) {
+            std::cerr << "Usage: " << argv[0] << " --compile-dictionary <input> <output>" << std::endl;
+            return 1;
+        }
+        return robsec::Dictionary::compile(argv[2], argv[3]) ? 0 : 1;
+    }
+
+    // Check every word of a dictionary: robsec --verify-dictionary words.bin
+    if ((argc > 1) && (std::string(argv[1]) == "--verify-dictionary")) {
+        if (argc != 3) {
+            std::cerr << "Usage: " << argv[0] << " --verify-dictionary <dictionary>" << std::endl;
+            return 1;
+        }
+        robsec::Dictionary dictionary;
+        if (!dictionary.load(argv[2]) || !dictionary.verify()) {
+            return 1;
+        }
+        std::cout << "Verified " << dictionary.get_size() << " words in `" << argv[2] << "`." << std::endl;
+        return 0;
+    }
+
     cmdlp::Parser parser(argc, argv);
-    parser.addOption("-d", "--dictionary", "The path to the dictionary.", "", true);
+    parser.addOption("-d", "--dictionary", "The comma-separated paths to the dictionary files or directories.", "", true);
+    parser.addToggle("-u", "--unique", "Keeps only once the words repeated in the dictionaries.", false);
     parser.addOption("-p", "--pannels", "The number of pannels.", 3, false);
     parser.addOption("-r", "--rows", "The number of rows.", 20, false);
     parser.addOption("-c", "--columns", "The number of columns.", 12, false);
     parser.addOption("-w", "--words", "The number of words.", 12, false);
     parser.addOption("-a", "--attemps", "The number of attemps.", 4, false);
+    parser.addOption("-s", "--seed", "The seed used to generate the board (0 for a random one).", 0, false);
+    parser.addOption("-g", "--generate", "Generates the given number of boards, without playing.", 0, false);
+    parser.addOption("-o", "--output", "The file where the generated boards are written (default: stdout).", "", false);
+    parser.addOption("-S", "--serve", "Serves the game over telnet on the given port, instead of playing.", 0, false);
+    parser.addToggle("-C", "--coalesce", "Handles all the pending keys before rendering a frame.", false);
+    parser.addOption("-R", "--record", "Records every input of the game to the given file.", "", false);
+    parser.addOption("-Y", "--replay", "Replays the recorded game in the given file, without a terminal.", "", false);
+    parser.addOption("-x", "--speed", "The speed of the replay: 'max', or a factor of the recorded pace.", "max", false);
+    parser.addOption("-T", "--stats", "Prints the statistics of the frames and of the initialization at exit: 'text' or 'json'.", "", false);
+    parser.addOption("-P", "--prefetch", "The number of boards generated ahead, in background (0 to disable).", 0, false);
+    parser.addToggle("-n", "--no-animation", "Shows the header and the feedback at once, instead of typing them.", false);
+    parser.addOption("-D", "--difficulty", "The difficulty of the boards: 'easy', 'medium' or 'hard' (default: random words).", "", false);
     parser.parseOptions();
 
-    robsec::Game game(
-        parser.getOption<std::string>("-d"),
-        parser.getOption<unsigned>("-p"),
-        parser.getOption<unsigned>("-r"),
-        parser.getOption<unsigned>("-c"),
-        parser.getOption<unsigned>("-w"),
-        parser.getOption<int>("-a"));
-    if (!game.initialize()) {
+    // Check the difficulty.
+    robsec::Difficulty difficulty = robsec::Unrated;
+    if (!parser.getOption<std::string>("-D").empty() && !robsec::parse_difficulty(parser.getOption<std::string>("-D"), difficulty)) {
+        std::cerr << "Error: The difficulty must be 'easy', 'medium' or 'hard': " << parser.getOption<std::string>("-D") << std::endl;
         return 1;
     }
-    bool state = game.run();
-    game.stop();
+
+    if (parser.getOption<unsigned>("-g") > 0) {
+        return generate_boards(
+            parser.getOption<std::string>("-d"),
+            parser.getOption<bool>("-u"),
+            parser.getOption<unsigned>("-p"),
+            parser.getOption<unsigned>("-r"),
+            parser.getOption<unsigned>("-c"),
+            parser.getOption<unsigned>("-w"),
+            difficulty,
+            parser.getOption<unsigned>("-s"),
+            parser.getOption<unsigned>("-g"),
+            parser.getOption<std::string>("-o"));
+    }
+
+    // Collect the statistics, if requested.
+    const std::string stats_format = parser.getOption<std::string>("-T");
+    if (!stats_format.empty() && (stats_format != "text") && (stats_format != "json")) {
+        std::cerr << "Error: The statistics format must be 'text' or 'json': " << stats_format << std::endl;
+        return 1;
+    }
+    std::unique_ptr<robsec::GameStats> stats(stats_format.empty() ? nullptr : new robsec::GameStats());
+
+    // Load the dictionary, shared by all the games.
+    auto begin                                           = std::chrono::steady_clock::now();
+    std::shared_ptr<const robsec::Dictionary> dictionary = robsec::DictionaryCache::acquire(parser.getOption<std::string>("-d"), parser.getOption<bool>("-u"));
+    if (!dictionary) {
+        std::cerr << "Error: Failed to load the dictionary." << std::endl;
+        return 1;
+    }
+    if (stats) {
+        stats->dictionary_load = robsec::elapsed_s(begin, std::chrono::steady_clock::now());
+    }
+
+    // A replay takes its difficulty from the recording, and indexes the words itself.
+    if (!parser.getOption<std::string>("-Y").empty()) {
+        int result = replay_game(dictionary, parser.getOption<std::string>("-Y"), parser.getOption<std::string>("-x"), stats.get());
+        write_stats(stats.get(), stats_format);
+        return result;
+    }
+
+    // Index the likeness of the words, if the difficulty is rated.
+    robsec::LikenessIndex index;
+    if (difficulty != robsec::Unrated) {
+        begin = std::chrono::steady_clock::now();
+        index.build(*dictionary, robsec::LikenessIndex::neighbors_per_board_word * parser.getOption<unsigned>("-w"));
+        if (stats) {
+            stats->index_build = robsec::elapsed_s(begin, std::chrono::steady_clock::now());
+        }
+    }
+
+    // Resolve the seed now, so that a recording can store it.
+    unsigned seed = robsec::resolve_seed(parser.getOption<unsigned>("-s"));
+
+    // Generate the boards in background, if requested.
+    std::unique_ptr<robsec::BoardPrefetcher> prefetcher;
+    if (parser.getOption<unsigned>("-P") > 0) {
+        robsec::BoardGenerator generator(
+            *dictionary,
+            parser.getOption<unsigned>("-p"),
+            parser.getOption<unsigned>("-r"),
+            parser.getOption<unsigned>("-c"),
+            parser.getOption<unsigned>("-w"));
+        generator.set_difficulty(&index, difficulty);
+        prefetcher.reset(new robsec::BoardPrefetcher(generator, parser.getOption<unsigned>("-P"), seed));
+    }
+
+    if (parser.getOption<unsigned>("-S") > 0) {
+        robsec::Server server(
+            dictionary,
+            parser.getOption<unsigned>("-p"),
+            parser.getOption<unsigned>("-r"),
+            parser.getOption<unsigned>("-c"),
+            parser.getOption<unsigned>("-w"),
+            parser.getOption<int>("-a"),
+            parser.getOption<unsigned>("-s"),
+            prefetcher.get());
+        server.set_difficulty(&index, difficulty);
+        server.set_animated(!parser.getOption<bool>("-n"));
+        return server.serve(static_cast<uint16_t>(parser.getOption<unsigned>("-S"))) ? 0 : 1;
+    }
+
+    // Record the input, if requested.
+    robsec::InputRecorder recorder;
+    bool recording = !parser.getOption<std::string>("-R").empty();
+    if (recording) {
+        robsec::RecordingHeader header{ seed,
+                                        parser.getOption<unsigned>("-p"),
+                                        parser.getOption<unsigned>("-r"),
+                                        parser.getOption<unsigned>("-c"),
+                                        parser.getOption<unsigned>("-w"),
+                                        parser.getOption<int>("-a"),
+                                        static_cast<uint32_t>(difficulty) };
+        if (!recorder.open(parser.getOption<std::string>("-R"), header)) {
+            return 1;
+        }
+    }
+
+    // Play with the specialized game, if the layout is the standard one.
+    robsec::CursesRenderTarget target;
+    bool state;
+    if (robsec::StandardGame::matches(parser.getOption<unsigned>("-p"), parser.getOption<unsigned>("-r"), parser.getOption<unsigned>("-c"))) {
+        robsec::StandardGame game(
+            target,
+            dictionary,
+            parser.getOption<unsigned>("-p"),
+            parser.getOption<unsigned>("-r"),
+            parser.getOption<unsigned>("-c"),
+            parser.getOption<unsigned>("-w"),
+            parser.getOption<int>("-a"),
+            seed,
+            prefetcher.get());
+        game.set_difficulty(&index, difficulty);
+        game.set_animated(!parser.getOption<bool>("-n"));
+        if (!play_game(game, parser.getOption<bool>("-C"), recording ? &recorder : nullptr, stats.get(), state)) {
+            return 1;
+        }
+    } else {
+        robsec::Game game(
+            target,
+            dictionary,
+            parser.getOption<unsigned>("-p"),
+            parser.getOption<unsigned>("-r"),
+            parser.getOption<unsigned>("-c"),
+            parser.getOption<unsigned>("-w"),
+            parser.getOption<int>("-a"),
+            seed,
+            prefetcher.get());
+        game.set_difficulty(&index, difficulty);
+        game.set_animated(!parser.getOption<bool>("-n"));
+        if (!play_game(game, parser.getOption<bool>("-C"), recording ? &recorder : nullptr, stats.get(), state)) {
+            return 1;
+        }
+    }
 
     if (state) {
         printf("Terminal unlocked\n");
     } else {
         printf("Terminal locked\n");
-        return 1;
     }
-    return 0;
+    write_stats(stats.get(), stats_format);
+    return state ? 0 : 1;
 }
@@ -0,0 +1,75 @@
+/// @file allocation_counter.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Implementation of the process-wide counter of the heap allocations.
+
+#include "robsec/allocation_counter.hpp"
+
+#ifdef ROBSEC_COUNT_ALLOCATIONS
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+/// @brief The number of calls to the global operator new.
+static std::atomic<std::size_t> allocations(0);
+
+void *operator new(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *pointer = std::malloc(size ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size)
+{
+    return ::operator new(size);
+}
+
+void operator delete(void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+#ifdef __cpp_sized_deallocation
+void operator delete(void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+#endif
+
+#endif
+
+namespace robsec
+{
+
+bool counting_allocations()
+{
+#ifdef ROBSEC_COUNT_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::size_t allocation_count()
+{
+#ifdef ROBSEC_COUNT_ALLOCATIONS
+    return allocations.load(std::memory_order_relaxed);
+#else
+    return 0;
+#endif
+}
+
+} // namespace robsec
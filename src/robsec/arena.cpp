@@ -0,0 +1,72 @@
+/// @file arena.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Implementation of the bump allocator.
+
+#include "robsec/arena.hpp"
+
+#include <algorithm>
+
+namespace robsec
+{
+
+Arena::Arena(std::size_t _chunk_size)
+    : chunk_size(_chunk_size),
+      chunks(),
+      used(0)
+{
+    // Nothing to do.
+}
+
+Arena::~Arena()
+{
+    for (const auto &chunk : chunks) {
+        delete[] chunk.data;
+    }
+}
+
+void *Arena::allocate(std::size_t size, std::size_t alignment)
+{
+    // Align the first free byte of the current chunk.
+    if (!chunks.empty()) {
+        std::size_t address = reinterpret_cast<std::size_t>(chunks.back().data + used);
+        std::size_t offset  = used + ((alignment - address % alignment) % alignment);
+        if (offset + size <= chunks.back().size) {
+            used = offset + size;
+            return chunks.back().data + offset;
+        }
+    }
+    // Take a new chunk, at least twice the previous one so that the number
+    // of chunks stays logarithmic, and large enough for the aligned block.
+    std::size_t previous = chunks.empty() ? 0 : chunks.back().size;
+    Chunk chunk{ nullptr, std::max(std::max(chunk_size, 2 * previous), size + alignment) };
+    chunk.data = new char[chunk.size];
+    chunks.push_back(chunk);
+    used = 0;
+    return this->allocate(size, alignment);
+}
+
+void Arena::reset()
+{
+    // Merge the chunks into one, large enough for all the previous content.
+    if (chunks.size() > 1) {
+        Chunk chunk{ nullptr, this->get_capacity() };
+        for (const auto &other : chunks) {
+            delete[] other.data;
+        }
+        chunks.clear();
+        chunk.data = new char[chunk.size];
+        chunks.push_back(chunk);
+    }
+    used = 0;
+}
+
+std::size_t Arena::get_capacity() const
+{
+    std::size_t capacity = 0;
+    for (const auto &chunk : chunks) {
+        capacity += chunk.size;
+    }
+    return capacity;
+}
+
+} // namespace robsec
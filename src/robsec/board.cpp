@@ -0,0 +1,503 @@
+/// @file board.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Implementation of the board generator.
+
+#include "robsec/board.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+/// @brief Minimum size of the chunks of the board arena, in bytes.
+static const std::size_t board_arena_chunk_size = 16384;
+
+/// @brief Number of candidates, for each word of an easy board, among which the likeness is spread.
+static const std::size_t spread_candidates_per_word = 8;
+
+// The comma is listed twice, so it is drawn twice as often.
+const char robsec::Board::garbage[] = ",|\\!@#$%^&*-_+=.:;?,/()[]{}<>";
+
+/// @brief Fills a buffer with random garbage characters.
+///
+/// @param engine The random engine used to pick the characters.
+/// @param s The buffer to fill.
+/// @param width The number of characters to generate.
+static inline void generate_garbage_string(robsec::RandomEngine &engine, char *s, std::size_t width)
+{
+    // Uniform distribution over the garbage characters (excluding the terminator).
+    std::uniform_int_distribution<std::size_t> dist(0, sizeof(robsec::Board::garbage) - 2);
+
+    // Generate a random character for each position in the string.
+    for (std::size_t i = 0; i < width; ++i) {
+        // Select a random character from the garbage array.
+        s[i] = robsec::Board::garbage[dist(engine)];
+    }
+}
+
+/// @brief Returns the kind of a bracket.
+///
+/// @param c The character.
+/// @param opening Receives true for an opening bracket.
+/// @return The kind of the bracket, between 0 and 3, or -1 for the other characters.
+static inline int bracket_kind(char c, bool &opening)
+{
+    static const char brackets[] = "([{<)]}>";
+    for (int i = 0; i < 8; ++i) {
+        if (brackets[i] == c) {
+            opening = i < 4;
+            return i % 4;
+        }
+    }
+    return -1;
+}
+
+/// @brief Set of the ids picked for a board, open addressing over slots of the board arena.
+/// @details It is sized by the number of words rather than by the group, so
+/// that a board drawn from a huge group does not clear a bitset of the group.
+class PickedIds {
+    robsec::ArenaVector<uint32_t> slots; ///< The ids, or no_word for the empty slots.
+    std::size_t mask;                    ///< Number of slots, a power of two, minus one.
+
+public:
+    /// @brief Constructs an empty set, with room for the given number of ids.
+    PickedIds(robsec::Arena &arena, std::size_t n_ids)
+        : slots(robsec::ArenaAllocator<uint32_t>(arena)),
+          mask(0)
+    {
+        // Keep the load under one half, so that the probes stay short.
+        std::size_t size = 16;
+        while (size < 2 * n_ids) {
+            size <<= 1;
+        }
+        slots.assign(size, robsec::Board::no_word);
+        mask = size - 1;
+    }
+
+    /// @brief Checks if the id was picked.
+    bool contains(uint32_t id) const
+    {
+        return slots[this->find(id)] == id;
+    }
+
+    /// @brief Picks the id.
+    /// @return false if it was already picked, true otherwise.
+    bool insert(uint32_t id)
+    {
+        std::size_t slot = this->find(id);
+        if (slots[slot] == id) {
+            return false;
+        }
+        slots[slot] = id;
+        return true;
+    }
+
+private:
+    /// @brief Returns the slot holding the id, or the empty one where it goes.
+    std::size_t find(uint32_t id) const
+    {
+        std::size_t slot = static_cast<std::size_t>(id * 2654435761U) & mask;
+        while ((slots[slot] != id) && (slots[slot] != robsec::Board::no_word)) {
+            slot = (slot + 1) & mask;
+        }
+        return slot;
+    }
+};
+
+namespace robsec
+{
+
+const uint32_t Board::no_word = UINT32_MAX;
+
+Board::Board()
+    : arena(new Arena(board_arena_chunk_size)),
+      n_panels(0),
+      n_rows(0),
+      n_columns(0),
+      start_address(0),
+      group(nullptr),
+      word_ids(ArenaAllocator<uint32_t>(*arena)),
+      word_panels(ArenaAllocator<uint32_t>(*arena)),
+      word_starts(ArenaAllocator<uint32_t>(*arena)),
+      solution_index(0),
+      content(ArenaAllocator<char>(*arena)),
+      cells(ArenaAllocator<uint32_t>(*arena)),
+      pairs(ArenaAllocator<uint32_t>(*arena)),
+      likeness()
+{
+    // Nothing to do.
+}
+
+void Board::clear()
+{
+    start_address  = 0;
+    group          = nullptr;
+    solution_index = 0;
+    // Drop the containers without freeing them, then release their memory at once.
+    word_ids    = ArenaVector<uint32_t>(ArenaAllocator<uint32_t>(*arena));
+    word_panels = ArenaVector<uint32_t>(ArenaAllocator<uint32_t>(*arena));
+    word_starts = ArenaVector<uint32_t>(ArenaAllocator<uint32_t>(*arena));
+    content     = ArenaVector<char>(ArenaAllocator<char>(*arena));
+    cells       = ArenaVector<uint32_t>(ArenaAllocator<uint32_t>(*arena));
+    pairs       = ArenaVector<uint32_t>(ArenaAllocator<uint32_t>(*arena));
+    arena->reset();
+    likeness.clear();
+}
+
+void Board::index_words()
+{
+    cells.assign(n_panels * n_rows * n_columns, no_word);
+    std::size_t length = this->get_word_length();
+    for (std::size_t i = 0; i < word_ids.size(); ++i) {
+        uint32_t *cell = &cells[word_panels[i] * n_rows * n_columns + word_starts[i]];
+        std::fill(cell, cell + length, static_cast<uint32_t>(i));
+    }
+}
+
+void Board::index_brackets()
+{
+    // Scan each row backwards, keeping the nearest closing bracket of each
+    // kind. A word breaks the pairs across it.
+    pairs.assign(cells.size(), 0);
+    for (std::size_t begin = 0; begin < cells.size(); begin += n_columns) {
+        std::size_t nearest[4] = { SIZE_MAX, SIZE_MAX, SIZE_MAX, SIZE_MAX };
+        for (std::size_t i = begin + n_columns; i-- > begin;) {
+            bool opening = false;
+            int kind     = bracket_kind(content[i], opening);
+            if (cells[i] != no_word) {
+                std::fill(nearest, nearest + 4, SIZE_MAX);
+            } else if ((kind >= 0) && !opening) {
+                nearest[kind] = i;
+            } else if ((kind >= 0) && (nearest[kind] != SIZE_MAX)) {
+                pairs[i] = static_cast<uint32_t>(nearest[kind] - i + 1);
+            }
+        }
+    }
+}
+
+void Board::remove_word(std::size_t index)
+{
+    std::size_t cell = word_panels[index] * n_rows * n_columns + word_starts[index];
+    std::fill(&cells[cell], &cells[cell] + this->get_word_length(), no_word);
+    std::fill(&content[cell], &content[cell] + this->get_word_length(), '.');
+}
+
+BoardGenerator::BoardGenerator(const Dictionary &_dictionary,
+                               std::size_t _n_panels,
+                               std::size_t _n_rows,
+                               std::size_t _n_columns,
+                               std::size_t _n_words)
+    : dictionary(_dictionary),
+      n_panels(_n_panels),
+      n_rows(_n_rows),
+      n_columns(_n_columns),
+      n_words(_n_words),
+      index(nullptr),
+      difficulty(Unrated)
+{
+    // Nothing to do.
+}
+
+void BoardGenerator::set_difficulty(const LikenessIndex *_index, Difficulty _difficulty)
+{
+    index      = _index;
+    difficulty = _difficulty;
+}
+
+bool BoardGenerator::generate(Board &board, RandomEngine &engine) const
+{
+    return this->generate(board, engine, nullptr);
+}
+
+bool BoardGenerator::generate(Board &board, RandomEngine &engine, GenerationTimings *timings) const
+{
+    // The clock is read only when timing.
+    std::chrono::steady_clock::time_point begin, end;
+    if (timings) {
+        begin = std::chrono::steady_clock::now();
+    }
+
+    // Start from an empty board.
+    board.clear();
+    board.n_panels  = n_panels;
+    board.n_rows    = n_rows;
+    board.n_columns = n_columns;
+
+    // Collect the groups with enough words for the board. The scratch
+    // buffers are taken from the board arena too.
+    ArenaVector<const DictionaryGroup *> candidates(ArenaAllocator<const DictionaryGroup *>(*board.arena));
+    candidates.reserve(dictionary.get_groups().size());
+    for (const auto &group : dictionary.get_groups()) {
+        // Each panel fits a word, plus the separator, every (length + 1) cells.
+        std::size_t capacity = n_panels * ((n_rows * n_columns + 1) / (group.length + 1));
+        if ((group.size() > (2 * n_words)) && (capacity >= n_words)) {
+            candidates.push_back(&group);
+        }
+    }
+
+    // Check if all groups were discarded.
+    if (candidates.empty()) {
+        std::cerr << "Error: All dictionary groups were discarded due to n_words being too high (" << n_words << ") for the layout.\n"
+                  << "Total groups in the dictionary: " << dictionary.get_groups().size() << "." << std::endl;
+        return false;
+    }
+
+    // Get a random dictionary group.
+    const DictionaryGroup *group = *select_randomly(candidates.begin(), candidates.end(), engine);
+
+    // Ensure we don't attempt to place more words than are available.
+    std::size_t total_words = std::min(n_words, group->size());
+
+    // Ensure there are words to place.
+    if (total_words == 0) {
+        std::cerr << "Error: No words available to place after adjustments." << std::endl;
+        return false;
+    }
+
+    // Track the free space of the panels. Each word also takes the cell that
+    // follows it, so that two words are always separated by some garbage.
+    FreeSpaceIndex free_space(*board.arena);
+    free_space.reset(n_panels, n_rows * n_columns + 1, group->length + 1, total_words);
+
+    // Pick the words, and the solution when the difficulty is rated.
+    board.group = group;
+    board.word_ids.reserve(total_words);
+    board.word_panels.reserve(total_words);
+    board.word_starts.reserve(total_words);
+    bool rated           = index && (difficulty != Unrated);
+    std::size_t solution = 0;
+    if (rated) {
+        solution = this->select_rated_words(board, total_words, engine);
+    } else {
+        this->select_random_words(board, total_words, engine);
+    }
+
+    // Place the words.
+    for (std::size_t i = 0; i < total_words; ++i) {
+        // Find a random place, this fails only if the remaining words do not fit.
+        std::size_t panel, start;
+        if (!this->find_unoccupied_space_for_word(free_space, total_words - i, panel, start, engine)) {
+            std::cerr << "Error: There is no space left to place all the words." << std::endl;
+            return false;
+        }
+        board.word_panels.push_back(static_cast<uint32_t>(panel));
+        board.word_starts.push_back(static_cast<uint32_t>(start));
+    }
+
+    // Choose the solution.
+    board.solution_index = rated ? solution : random_number<std::size_t>(engine, 0, board.get_n_words() - 1);
+
+    // Compute the starting address.
+    board.start_address = random_number<std::size_t>(engine, 0xA000, 0xFFFF - n_rows * n_panels * n_columns);
+
+    if (timings) {
+        end                = std::chrono::steady_clock::now();
+        timings->placement = elapsed_s(begin, end);
+        begin              = end;
+    }
+
+    // Fill the panel content with garbage strings.
+    try {
+        board.content.resize(n_panels * n_rows * n_columns);
+        for (std::size_t c = 0; c < n_panels; ++c) {
+            generate_garbage_string(engine, &board.content[c * n_rows * n_columns], n_rows * n_columns);
+        }
+    } catch (const std::exception &e) {
+        std::cerr << "Error: Failed to generate garbage strings for panel content. Exception: " << e.what() << std::endl;
+        return false;
+    }
+
+    // Map each cell to the word covering it, and to the bracket pair opening at it.
+    board.index_words();
+    board.index_brackets();
+
+    if (timings) {
+        end              = std::chrono::steady_clock::now();
+        timings->garbage = elapsed_s(begin, end);
+        begin            = end;
+    }
+
+    // Compute the likeness between every pair of words.
+    board.likeness.build(*group, board.word_ids.data(), board.get_n_words());
+
+    if (timings) {
+        timings->likeness = elapsed_s(begin, std::chrono::steady_clock::now());
+    }
+    return true;
+}
+
+void BoardGenerator::select_random_words(Board &board, std::size_t total_words, RandomEngine &engine) const
+{
+    // Sample distinct ids with Floyd's algorithm: the draw for j is taken
+    // among the first (j + 1) ids, and j itself replaces a draw that was
+    // already picked, and is never picked itself. This costs O(n_words)
+    // whatever the size of the group.
+    const DictionaryGroup &group = *board.group;
+    PickedIds picked(*board.arena, total_words);
+    for (std::size_t j = group.size() - total_words; j < group.size(); ++j) {
+        uint32_t id = random_number<uint32_t>(engine, 0, static_cast<uint32_t>(j));
+        if (!picked.insert(id)) {
+            id = static_cast<uint32_t>(j);
+            picked.insert(id);
+        }
+        board.word_ids.push_back(id);
+    }
+}
+
+std::size_t BoardGenerator::select_rated_words(Board &board, std::size_t total_words, RandomEngine &engine) const
+{
+    const DictionaryGroup &group = *board.group;
+    std::size_t group_index      = static_cast<std::size_t>(board.group - dictionary.get_groups().data());
+
+    // Take the solution at random, and count its neighbors.
+    uint32_t solution         = random_number<uint32_t>(engine, 0, static_cast<uint32_t>(group.size() - 1));
+    const uint32_t *neighbors = index->get_neighbors(group_index, solution);
+    std::size_t n_neighbors   = 0;
+    while ((n_neighbors < index->get_n_neighbors()) && (neighbors[n_neighbors] != LikenessIndex::no_neighbor)) {
+        ++n_neighbors;
+    }
+    board.word_ids.push_back(solution);
+    PickedIds picked(*board.arena, total_words);
+    picked.insert(solution);
+
+    // Count how many words have each likeness with the solution.
+    std::size_t counts[256] = { 0 };
+    auto count = [&](uint32_t id) {
+        ++counts[count_common_letters(group[id].data, group[solution].data)];
+    };
+
+    // Sample the near words among the neighbors, with Floyd's algorithm over
+    // their positions: all the others on hard boards, half of them on medium
+    // ones, a quarter on easy ones.
+    std::size_t n_near = (difficulty == Hard) ? (total_words - 1) : ((difficulty == Medium) ? (total_words - 1) / 2 : (total_words - 1) / 4);
+    n_near             = std::min(n_near, n_neighbors);
+    for (std::size_t j = n_neighbors - n_near; j < n_neighbors; ++j) {
+        std::size_t position = random_number<std::size_t>(engine, 0, j);
+        if (!picked.insert(neighbors[position])) {
+            position = j;
+            picked.insert(neighbors[position]);
+        }
+        board.word_ids.push_back(neighbors[position]);
+        count(neighbors[position]);
+    }
+
+    // Fill the rest with random words, on medium and hard boards.
+    if (difficulty != Easy) {
+        while (board.word_ids.size() < total_words) {
+            uint32_t id = random_number<uint32_t>(engine, 0, static_cast<uint32_t>(group.size() - 1));
+            if (picked.insert(id)) {
+                board.word_ids.push_back(id);
+            }
+        }
+    } else {
+        // On easy boards, the likeness with the solution is spread over all
+        // its values, so that every guess tells the words apart. A pool of
+        // distinct random words is bucketed by its likeness, then the buckets
+        // are taken in turn, each up to a level raised once all reached it.
+        const std::size_t n_values = group.length + 1;
+        const std::size_t n_pool   = std::min(group.size(), spread_candidates_per_word * total_words);
+        ArenaVector<uint32_t> pool(ArenaAllocator<uint32_t>(*board.arena));
+        ArenaVector<uint8_t> values(ArenaAllocator<uint8_t>(*board.arena));
+        pool.reserve(n_pool);
+        values.reserve(n_pool);
+        std::size_t starts[257] = { 0 };
+        PickedIds sampled(*board.arena, n_pool);
+        for (std::size_t j = group.size() - n_pool; j < group.size(); ++j) {
+            uint32_t id = random_number<uint32_t>(engine, 0, static_cast<uint32_t>(j));
+            if (!sampled.insert(id)) {
+                id = static_cast<uint32_t>(j);
+                sampled.insert(id);
+            }
+            if (!picked.contains(id)) {
+                uint8_t value = static_cast<uint8_t>(count_common_letters(group[id].data, group[solution].data));
+                pool.push_back(id);
+                values.push_back(value);
+                ++starts[value + 1];
+            }
+        }
+
+        // Sort the pool by likeness, keeping the order of the draws in each bucket.
+        std::size_t next[256];
+        for (std::size_t value = 0; value < n_values; ++value) {
+            starts[value + 1] += starts[value];
+            next[value] = starts[value];
+        }
+        ArenaVector<uint32_t> buckets(pool.size(), 0, ArenaAllocator<uint32_t>(*board.arena));
+        for (std::size_t i = 0; i < pool.size(); ++i) {
+            buckets[next[values[i]]++] = pool[i];
+        }
+        std::copy(starts, starts + n_values, next);
+
+        // The pool holds at least the words still missing, so this ends.
+        for (std::size_t level = 1; board.word_ids.size() < total_words; ++level) {
+            for (std::size_t value = 0; (value < n_values) && (board.word_ids.size() < total_words); ++value) {
+                if ((counts[value] < level) && (next[value] < starts[value + 1])) {
+                    board.word_ids.push_back(buckets[next[value]++]);
+                    ++counts[value];
+                }
+            }
+        }
+    }
+
+    // Move the solution to a random place, so that it is not always the first word.
+    std::size_t position = random_number<std::size_t>(engine, 0, total_words - 1);
+    std::swap(board.word_ids[0], board.word_ids[position]);
+    return position;
+}
+
+bool BoardGenerator::find_unoccupied_space_for_word(FreeSpaceIndex &free_space,
+                                                    std::size_t remaining,
+                                                    std::size_t &panel,
+                                                    std::size_t &start,
+                                                    RandomEngine &engine) const
+{
+    // Sample directly a start among the free ones.
+    return free_space.occupy_random(engine, remaining, panel, start);
+}
+
+bool parse_difficulty(const std::string &name, Difficulty &difficulty)
+{
+    if (name == "easy") {
+        difficulty = Easy;
+    } else if (name == "medium") {
+        difficulty = Medium;
+    } else if (name == "hard") {
+        difficulty = Hard;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+std::ostream &operator<<(std::ostream &out, const Board &board)
+{
+    // Write the header of the board.
+    out << "ADDRESS 0x" << std::hex << std::uppercase << board.start_address << std::dec << "\n";
+    out << "SOLUTION ";
+    out.write(board.get_solution().data, static_cast<std::streamsize>(board.get_word_length()));
+    out << "\nWORDS";
+    for (std::size_t i = 0; i < board.get_n_words(); ++i) {
+        out << " ";
+        out.write(board.get_word(i).data, static_cast<std::streamsize>(board.get_word_length()));
+    }
+    out << "\n";
+
+    // Place the words over the garbage.
+    std::size_t panel_size = board.n_rows * board.n_columns;
+    std::string panels(board.content.data(), board.content.size());
+    for (std::size_t i = 0; i < board.get_n_words(); ++i) {
+        panels.replace(board.word_panels[i] * panel_size + board.word_starts[i], board.get_word_length(), board.get_word(i).data, board.get_word_length());
+    }
+
+    // Write the panels, one row at the time.
+    for (std::size_t r = 0; r < board.n_rows; ++r) {
+        for (std::size_t c = 0; c < board.n_panels; ++c) {
+            if (c > 0) {
+                out << "  ";
+            }
+            out.write(panels.data() + c * panel_size + r * board.n_columns, static_cast<std::streamsize>(board.n_columns));
+        }
+        out << "\n";
+    }
+    return out;
+}
+
+} // namespace robsec
@@ -0,0 +1,96 @@
+/// @file board_prefetcher.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Implementation of the board prefetcher.
+
+#include "robsec/board_prefetcher.hpp"
+
+#include <iostream>
+
+namespace robsec
+{
+
+BoardPrefetcher::BoardPrefetcher(const BoardGenerator &_generator, std::size_t _capacity, unsigned _seed)
+    : generator(_generator),
+      engine(resolve_seed(_seed)),
+      ring(_capacity + 1),
+      head(0),
+      tail(0),
+      failed(false),
+      stopping(false),
+      mutex(),
+      not_full(),
+      not_empty(),
+      worker()
+{
+    // Start the worker once everything else is initialized.
+    worker = std::thread(&BoardPrefetcher::run, this);
+}
+
+BoardPrefetcher::~BoardPrefetcher()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    not_full.notify_one();
+    worker.join();
+}
+
+bool BoardPrefetcher::pop(Board &board)
+{
+    std::size_t index = head.load(std::memory_order_relaxed);
+    if (index == tail.load(std::memory_order_acquire)) {
+        // Wait for the worker, it is either generating a board or it failed.
+        std::unique_lock<std::mutex> lock(mutex);
+        not_empty.wait(lock, [this, index]() { return failed || (index != tail.load(std::memory_order_acquire)); });
+        if (index == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+    }
+    // Take the board, and give its slot the buffers of the previous one.
+    std::swap(board, ring[index]);
+    head.store((index + 1) % ring.size(), std::memory_order_release);
+    {
+        // Taking the lock ensures the worker is either awake or waiting.
+        std::lock_guard<std::mutex> lock(mutex);
+    }
+    not_full.notify_one();
+    return true;
+}
+
+std::size_t BoardPrefetcher::get_size() const
+{
+    std::size_t first = head.load(std::memory_order_acquire);
+    std::size_t last  = tail.load(std::memory_order_acquire);
+    return (last + ring.size() - first) % ring.size();
+}
+
+void BoardPrefetcher::run()
+{
+    while (!stopping) {
+        std::size_t index = tail.load(std::memory_order_relaxed);
+        std::size_t next  = (index + 1) % ring.size();
+        if (next == head.load(std::memory_order_acquire)) {
+            // The queue is full, wait for the consumer.
+            std::unique_lock<std::mutex> lock(mutex);
+            not_full.wait(lock, [this, next]() { return stopping || (next != head.load(std::memory_order_acquire)); });
+            continue;
+        }
+        // Generate the board in its slot, which the consumer does not touch.
+        if (!generator.generate(ring[index], engine)) {
+            std::cerr << "Error: Failed to prefetch a board." << std::endl;
+            std::lock_guard<std::mutex> lock(mutex);
+            failed = true;
+            not_empty.notify_one();
+            return;
+        }
+        tail.store(next, std::memory_order_release);
+        {
+            // Taking the lock ensures the consumer is either awake or waiting.
+            std::lock_guard<std::mutex> lock(mutex);
+        }
+        not_empty.notify_one();
+    }
+}
+
+} // namespace robsec
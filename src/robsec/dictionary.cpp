@@ -0,0 +1,520 @@
+/// @file dictionary.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Implementation of the dictionary loader.
+
+#include "robsec/dictionary.hpp"
+#include "robsec/thread_pool.hpp"
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <unordered_set>
+
+/// @brief Maximum supported length of a word, excluded.
+#define MAX_WORD_LENGTH 256
+
+/// @brief Size of the chunks the text dictionaries are split into, in bytes.
+#define TEXT_CHUNK_SIZE (1 << 20)
+
+/// @brief Magic bytes at the beginning of a compiled dictionary.
+#define DICTIONARY_MAGIC "ROBSDICT"
+
+/// @brief Version of the compiled dictionary format.
+#define DICTIONARY_VERSION 1
+
+/// @brief Header of a compiled dictionary.
+/// @details It is followed by `n_groups` entries of `BinaryGroup`, and then by
+/// `data_size` bytes of packed, null-terminated, uppercase words. All the
+/// fields are stored in the native byte order.
+struct BinaryHeader {
+    char magic[8];      ///< Must match DICTIONARY_MAGIC.
+    uint32_t version;   ///< Must match DICTIONARY_VERSION.
+    uint32_t n_groups;  ///< Number of entries in the group table.
+    uint64_t n_words;   ///< Total number of words.
+    uint64_t data_size; ///< Size of the packed words, in bytes.
+};
+
+/// @brief Entry of the group table of a compiled dictionary.
+struct BinaryGroup {
+    uint64_t length; ///< Length of the words in the group.
+    uint64_t count;  ///< Number of words in the group.
+    uint64_t offset; ///< Offset of the first word, from the beginning of the packed words.
+};
+
+/// @brief Checks if the character separates two words, like `std::isspace`.
+///
+/// @param c The character to check.
+/// @return true if the character is a separator, false otherwise.
+static inline bool is_separator(char c)
+{
+    return (c == ' ') || (c == '\n') || (c == '\r') || (c == '\t') || (c == '\v') || (c == '\f');
+}
+
+/// @brief Checks a word of a compiled dictionary, as the text loader would have written it.
+///
+/// @param word Pointer to the first character of the word.
+/// @param length The length of the word, followed by its terminator.
+/// @return true if the word is uppercase, without separators, and null-terminated.
+static inline bool is_compiled_word(const char *word, std::size_t length)
+{
+    for (std::size_t i = 0; i < length; ++i) {
+        const char c = word[i];
+        if ((c == '\0') || is_separator(c) || (std::toupper(static_cast<unsigned char>(c)) != static_cast<unsigned char>(c))) {
+            return false;
+        }
+    }
+    return word[length] == '\0';
+}
+
+/// @brief Calls the given function for each word in the buffer.
+///
+/// @tparam Function Type of the function, called with the word and its length.
+/// @param it Pointer to the beginning of the buffer.
+/// @param end Pointer to the end of the buffer.
+/// @param fun The function to call.
+template <typename Function>
+static inline void for_each_word(const char *it, const char *end, Function fun)
+{
+    while (it != end) {
+        // Skip the separators.
+        if (is_separator(*it)) {
+            ++it;
+            continue;
+        }
+        // Find the end of the word.
+        const char *word = it;
+        while ((it != end) && !is_separator(*it)) {
+            ++it;
+        }
+        fun(word, static_cast<std::size_t>(it - word));
+    }
+}
+
+/// @brief A slice of a text dictionary, parsed by a single task.
+struct TextChunk {
+    const char *begin;               ///< First character of the chunk.
+    const char *end;                 ///< One past the last character of the chunk.
+    std::vector<std::size_t> counts; ///< Words of each length, then where the next one of each length is written.
+    std::size_t skipped;             ///< Number of words exceeding the maximum length.
+};
+
+/// @brief Hashes the characters of a word, with FNV-1a.
+struct WordViewHash {
+    /// @brief Returns the hash of the word.
+    std::size_t operator()(const robsec::WordView &word) const
+    {
+        uint64_t hash = 14695981039346656037ULL;
+        for (std::size_t i = 0; i < word.length; ++i) {
+            hash = (hash ^ static_cast<unsigned char>(word.data[i])) * 1099511628211ULL;
+        }
+        return static_cast<std::size_t>(hash);
+    }
+};
+
+/// @brief Calls the given function for each task, on a pool of threads when
+/// there is more than one task.
+///
+/// @tparam Function Type of the function, called with the index of the task.
+/// @param n_tasks The number of tasks.
+/// @param n_threads The number of threads, 0 for one per hardware thread.
+/// @param fun The function to call.
+template <typename Function>
+static inline void run_tasks(std::size_t n_tasks, std::size_t n_threads, Function fun)
+{
+    if ((n_tasks <= 1) || (n_threads == 1)) {
+        for (std::size_t i = 0; i < n_tasks; ++i) {
+            fun(i);
+        }
+        return;
+    }
+    if (n_threads == 0) {
+        n_threads = std::max(1U, std::thread::hardware_concurrency());
+    }
+    robsec::ThreadPool pool(std::min(n_threads, n_tasks));
+    for (std::size_t i = 0; i < n_tasks; ++i) {
+        pool.submit([&fun, i]() { fun(i); });
+    }
+    pool.wait();
+}
+
+/// @brief Checks if the buffer starts with the header of a compiled dictionary.
+///
+/// @param begin Pointer to the beginning of the buffer.
+/// @param size The size of the buffer.
+/// @return true if the buffer is a compiled dictionary, false otherwise.
+static inline bool is_compiled(const char *begin, std::size_t size)
+{
+    return (size >= sizeof(BinaryHeader)) && (std::memcmp(begin, DICTIONARY_MAGIC, 8) == 0);
+}
+
+namespace robsec
+{
+
+Dictionary::Dictionary()
+    : mapping(),
+      arena(),
+      size(0),
+      groups()
+{
+    // Nothing to do.
+}
+
+bool Dictionary::load(const std::string &path)
+{
+    return this->load(std::vector<std::string>(1, path), 0, false);
+}
+
+bool Dictionary::load(const std::vector<std::string> &paths, std::size_t n_threads, bool deduplicate)
+{
+    // Clean the previous content.
+    mapping.close();
+    arena.clear();
+    groups.clear();
+    size = 0;
+
+    if (paths.empty()) {
+        std::cerr << "Error: There is no dictionary to load." << std::endl;
+        return false;
+    }
+
+    // Map the dictionary files, the first one in the mapping of the dictionary.
+    std::vector<std::unique_ptr<MappedFile>> others;
+    std::vector<std::pair<const char *, const char *>> inputs;
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+        MappedFile *file = &mapping;
+        if (i > 0) {
+            others.emplace_back(new MappedFile());
+            file = others.back().get();
+        }
+        if (!file->open(paths[i])) {
+            std::cerr << "Failed to open dictionary file: " << paths[i] << std::endl;
+            mapping.close();
+            return false; // Return false if the file cannot be opened.
+        }
+        inputs.emplace_back(file->get_data(), file->get_data() + file->get_size());
+        // Detect the format of the dictionary.
+        if (is_compiled(file->get_data(), file->get_size()) && ((paths.size() > 1) || deduplicate)) {
+            std::cerr << "Error: The compiled dictionary `" << paths[i] << "` can only be loaded alone, and as it is." << std::endl;
+            mapping.close();
+            return false;
+        }
+    }
+
+    if (is_compiled(mapping.get_data(), mapping.get_size())) {
+        // The groups point straight into the mapping, so keep it open.
+        if (!this->parse_binary(inputs[0].first, inputs[0].second)) {
+            std::cerr << "Error: The compiled dictionary `" << paths[0] << "` is malformed." << std::endl;
+            mapping.close();
+            return false;
+        }
+    } else {
+        // The words are copied in the arena, so the mappings are not needed anymore.
+        bool parsed = this->parse_text(inputs, n_threads);
+        mapping.close();
+        others.clear();
+        if (!parsed) {
+            return false;
+        }
+        if (deduplicate) {
+            this->deduplicate(n_threads);
+        }
+    }
+
+    // Check if the dictionary contains any word.
+    if (groups.empty()) {
+        if (paths.size() == 1) {
+            std::cerr << "Error: The dictionary `" << paths[0] << "` contains no words." << std::endl;
+        } else {
+            std::cerr << "Error: The " << paths.size() << " dictionaries contain no words." << std::endl;
+        }
+        return false;
+    }
+
+    return true;
+}
+
+bool Dictionary::list_files(const std::string &list, std::vector<std::string> &files)
+{
+    std::stringstream stream(list);
+    std::string path;
+    while (std::getline(stream, path, ',')) {
+        if (path.empty()) {
+            continue;
+        }
+        struct stat status;
+        if (stat(path.c_str(), &status) != 0) {
+            std::cerr << "Error: Failed to open the dictionary: " << path << std::endl;
+            return false;
+        }
+        if (!S_ISDIR(status.st_mode)) {
+            files.push_back(path);
+            continue;
+        }
+        // Take the regular files of the directory, in alphabetical order.
+        DIR *directory = opendir(path.c_str());
+        if (!directory) {
+            std::cerr << "Error: Failed to open the dictionary directory: " << path << std::endl;
+            return false;
+        }
+        std::vector<std::string> entries;
+        for (struct dirent *entry = readdir(directory); entry; entry = readdir(directory)) {
+            std::string file = path + "/" + entry->d_name;
+            if ((entry->d_name[0] != '.') && (stat(file.c_str(), &status) == 0) && S_ISREG(status.st_mode)) {
+                entries.push_back(file);
+            }
+        }
+        closedir(directory);
+        std::sort(entries.begin(), entries.end());
+        files.insert(files.end(), entries.begin(), entries.end());
+    }
+    return true;
+}
+
+bool Dictionary::save(const std::string &path) const
+{
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open output file: " << path << std::endl;
+        return false;
+    }
+
+    // Prepare the group table, and compute the size of the packed words.
+    std::vector<BinaryGroup> table;
+    table.reserve(groups.size());
+    uint64_t data_size = 0;
+    for (const auto &group : groups) {
+        table.push_back(BinaryGroup{ group.length, group.count, data_size });
+        data_size += group.count * (group.length + 1);
+    }
+
+    // Prepare the header.
+    BinaryHeader header;
+    std::memcpy(header.magic, DICTIONARY_MAGIC, 8);
+    header.version   = DICTIONARY_VERSION;
+    header.n_groups  = static_cast<uint32_t>(table.size());
+    header.n_words   = size;
+    header.data_size = data_size;
+
+    // Write everything.
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(table.data()), static_cast<std::streamsize>(table.size() * sizeof(BinaryGroup)));
+    for (const auto &group : groups) {
+        file.write(group.data, static_cast<std::streamsize>(group.count * (group.length + 1)));
+    }
+    if (!file) {
+        std::cerr << "Failed to write the compiled dictionary: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Dictionary::compile(const std::string &input_path, const std::string &output_path)
+{
+    Dictionary dictionary;
+    if (!dictionary.load(input_path)) {
+        return false;
+    }
+    if (!dictionary.save(output_path)) {
+        return false;
+    }
+    std::cout << "Compiled " << dictionary.get_size() << " words in " << dictionary.get_groups().size()
+              << " groups into `" << output_path << "`." << std::endl;
+    return true;
+}
+
+bool Dictionary::verify() const
+{
+    for (std::size_t i = 0; i < groups.size(); ++i) {
+        const DictionaryGroup &group = groups[i];
+        for (std::size_t j = 0; j < group.count; ++j) {
+            if (!is_compiled_word(group.data + j * (group.length + 1), group.length)) {
+                std::cerr << "Error: The word " << j << " of the words of length " << group.length << " is malformed." << std::endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+std::size_t Dictionary::get_size() const
+{
+    return size;
+}
+
+const std::vector<DictionaryGroup> &Dictionary::get_groups() const
+{
+    return groups;
+}
+
+bool Dictionary::parse_text(const std::vector<std::pair<const char *, const char *>> &inputs, std::size_t n_threads)
+{
+    // Split the inputs in chunks, ending each one at a separator so that no
+    // word is cut in two.
+    std::vector<TextChunk> chunks;
+    for (const auto &input : inputs) {
+        const char *it = input.first;
+        while (it != input.second) {
+            const char *end = (input.second - it > TEXT_CHUNK_SIZE) ? (it + TEXT_CHUNK_SIZE) : input.second;
+            while ((end != input.second) && !is_separator(*end)) {
+                ++end;
+            }
+            chunks.push_back(TextChunk{ it, end, std::vector<std::size_t>(MAX_WORD_LENGTH, 0), 0 });
+            it = end;
+        }
+    }
+
+    // First pass: count the words of each length, in each chunk.
+    run_tasks(chunks.size(), n_threads, [&chunks](std::size_t index) {
+        TextChunk &chunk = chunks[index];
+        for_each_word(chunk.begin, chunk.end, [&chunk](const char *, std::size_t length) {
+            // Ensure the word fits within the expected length bounds.
+            if (length >= MAX_WORD_LENGTH) {
+                ++chunk.skipped;
+                return;
+            }
+            ++chunk.counts[length];
+        });
+    });
+
+    // Compute where each group starts inside the arena, and where each chunk
+    // writes its words of each length, after the ones of the previous chunks.
+    std::vector<std::size_t> counts(MAX_WORD_LENGTH, 0);
+    std::vector<std::size_t> offsets(MAX_WORD_LENGTH, 0);
+    std::size_t total = 0;
+    for (std::size_t length = 0; length < MAX_WORD_LENGTH; ++length) {
+        offsets[length] = total;
+        for (auto &chunk : chunks) {
+            std::size_t count    = chunk.counts[length];
+            chunk.counts[length] = total;
+            total += count * (length + 1);
+            counts[length] += count;
+        }
+        size += counts[length];
+    }
+    std::size_t skipped = 0;
+    for (const auto &chunk : chunks) {
+        skipped += chunk.skipped;
+    }
+    if (skipped) {
+        std::cerr << "Skipping " << skipped << " word(s) exceeding the maximum supported length." << std::endl;
+    }
+    arena.resize(total);
+
+    // Second pass: write each word, uppercase, in its group.
+    run_tasks(chunks.size(), n_threads, [this, &chunks](std::size_t index) {
+        TextChunk &chunk = chunks[index];
+        for_each_word(chunk.begin, chunk.end, [this, &chunk](const char *word, std::size_t length) {
+            if (length >= MAX_WORD_LENGTH) {
+                return;
+            }
+            char *destination = arena.data() + chunk.counts[length];
+            for (std::size_t i = 0; i < length; ++i) {
+                destination[i] = static_cast<char>(std::toupper(static_cast<unsigned char>(word[i])));
+            }
+            destination[length] = '\0';
+            chunk.counts[length] += length + 1;
+        });
+    });
+
+    // Build the non-empty groups.
+    for (std::size_t length = 0; length < MAX_WORD_LENGTH; ++length) {
+        if (counts[length]) {
+            groups.push_back(DictionaryGroup{ length, counts[length], arena.data() + offsets[length] });
+        }
+    }
+    return true;
+}
+
+void Dictionary::deduplicate(std::size_t n_threads)
+{
+    // The groups are independent, so each one is compacted by its own task.
+    run_tasks(groups.size(), n_threads, [this](std::size_t index) {
+        DictionaryGroup &group = groups[index];
+        char *data             = arena.data() + (group.data - arena.data());
+        std::unordered_set<WordView, WordViewHash> seen;
+        seen.reserve(group.count);
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < group.count; ++i) {
+            if (seen.find(group[i]) != seen.end()) {
+                continue;
+            }
+            // Move the word right after the ones kept so far, and remember
+            // it there, since its previous place can be overwritten.
+            if (kept != i) {
+                std::memmove(data + kept * (group.length + 1), data + i * (group.length + 1), group.length + 1);
+            }
+            seen.insert(group[kept]);
+            ++kept;
+        }
+        group.count = kept;
+    });
+
+    // Update the total number of words.
+    size = 0;
+    for (const auto &group : groups) {
+        size += group.count;
+    }
+}
+
+bool Dictionary::parse_binary(const char *begin, const char *end)
+{
+    std::size_t available = static_cast<std::size_t>(end - begin);
+
+    // Read and check the header.
+    BinaryHeader header;
+    std::memcpy(&header, begin, sizeof(header));
+    if (header.version != DICTIONARY_VERSION) {
+        std::cerr << "Unsupported compiled dictionary version " << header.version << "." << std::endl;
+        return false;
+    }
+    std::size_t table_size = header.n_groups * sizeof(BinaryGroup);
+    if ((available - sizeof(header) < table_size) || (available - sizeof(header) - table_size < header.data_size)) {
+        std::cerr << "The compiled dictionary is truncated." << std::endl;
+        return false;
+    }
+    const char *data = begin + sizeof(header) + table_size;
+
+    // Build the groups over the group table, checking that they are in bounds
+    // and that they end with a terminator. The words themselves are only
+    // checked by verify(), so that mapping a dictionary does not read it all.
+    uint64_t n_words = 0;
+    groups.reserve(header.n_groups);
+    for (std::size_t i = 0; i < header.n_groups; ++i) {
+        BinaryGroup entry;
+        std::memcpy(&entry, begin + sizeof(header) + i * sizeof(BinaryGroup), sizeof(entry));
+        if ((entry.length == 0) || (entry.length >= MAX_WORD_LENGTH) || (entry.offset > header.data_size) ||
+            (entry.count > (header.data_size - entry.offset) / (entry.length + 1))) {
+            std::cerr << "The group " << i << " of the compiled dictionary is out of bounds." << std::endl;
+            groups.clear();
+            return false;
+        }
+        if ((entry.count > 0) && (data[entry.offset + entry.count * (entry.length + 1) - 1] != '\0')) {
+            std::cerr << "The group " << i << " of the compiled dictionary is not terminated." << std::endl;
+            groups.clear();
+            return false;
+        }
+        n_words += entry.count;
+        if (entry.count) {
+            groups.push_back(DictionaryGroup{
+                static_cast<std::size_t>(entry.length),
+                static_cast<std::size_t>(entry.count),
+                data + entry.offset });
+        }
+    }
+    if (n_words != header.n_words) {
+        std::cerr << "The compiled dictionary has " << n_words << " words in its groups, not " << header.n_words << "." << std::endl;
+        groups.clear();
+        return false;
+    }
+    size = static_cast<std::size_t>(header.n_words);
+    return true;
+}
+
+} // namespace robsec
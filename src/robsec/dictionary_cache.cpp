@@ -0,0 +1,103 @@
+/// @file dictionary_cache.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Implementation of the dictionary cache.
+
+#include "robsec/dictionary_cache.hpp"
+
+#include <sys/stat.h>
+
+#include <ctime>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace robsec
+{
+
+/// @brief The version of a file, to detect when it is modified.
+struct FileVersion {
+    std::time_t mtime; ///< Modification time of the file.
+    long long size;    ///< Size of the file.
+
+    /// @brief Equality operator to compare the versions.
+    bool operator==(const FileVersion &rhs) const
+    {
+        return (mtime == rhs.mtime) && (size == rhs.size);
+    }
+};
+
+/// @brief A dictionary of the cache, with the version of the files it was loaded from.
+struct CacheEntry {
+    std::vector<FileVersion> versions;          ///< Versions of the files.
+    std::weak_ptr<const Dictionary> dictionary; ///< The dictionary, while somebody uses it.
+};
+
+/// @brief Returns the mutex protecting the cache.
+static std::mutex &cache_mutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+/// @brief Returns the entries of the cache, by path.
+static std::map<std::string, CacheEntry> &cache_entries()
+{
+    static std::map<std::string, CacheEntry> entries;
+    return entries;
+}
+
+std::shared_ptr<const Dictionary> DictionaryCache::acquire(const std::string &path)
+{
+    return DictionaryCache::acquire(path, false);
+}
+
+std::shared_ptr<const Dictionary> DictionaryCache::acquire(const std::string &paths, bool deduplicate)
+{
+    // Find the files to load, and their current version.
+    std::vector<std::string> files;
+    if (!Dictionary::list_files(paths, files)) {
+        return std::shared_ptr<const Dictionary>();
+    }
+    std::vector<FileVersion> versions;
+    versions.reserve(files.size());
+    for (const auto &file : files) {
+        struct stat status;
+        if (stat(file.c_str(), &status) != 0) {
+            std::cerr << "Error: Failed to open the dictionary: " << file << std::endl;
+            return std::shared_ptr<const Dictionary>();
+        }
+        versions.push_back(FileVersion{ status.st_mtime, static_cast<long long>(status.st_size) });
+    }
+
+    // Loading under the lock makes concurrent users wait for a single load.
+    const std::string key = deduplicate ? (paths + "|unique") : paths;
+    std::lock_guard<std::mutex> lock(cache_mutex());
+    CacheEntry &entry = cache_entries()[key];
+    std::shared_ptr<const Dictionary> dictionary = entry.dictionary.lock();
+    if (dictionary && (entry.versions == versions)) {
+        return dictionary;
+    }
+
+    // Load the dictionary, the previous version stays alive for its users.
+    std::shared_ptr<Dictionary> loaded = std::make_shared<Dictionary>();
+    if (!loaded->load(files, 0, deduplicate)) {
+        cache_entries().erase(key);
+        return std::shared_ptr<const Dictionary>();
+    }
+    entry.versions   = versions;
+    entry.dictionary = loaded;
+    return loaded;
+}
+
+std::size_t DictionaryCache::get_size()
+{
+    std::lock_guard<std::mutex> lock(cache_mutex());
+    std::size_t size = 0;
+    for (const auto &entry : cache_entries()) {
+        size += entry.second.dictionary.expired() ? 0 : 1;
+    }
+    return size;
+}
+
+} // namespace robsec
@@ -0,0 +1,141 @@
+/// @file free_space.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Implementation of the free space index.
+
+#include "robsec/free_space.hpp"
+
+/// @brief Returns the lowest set bit of the given index.
+static inline std::size_t lowest_bit(std::size_t i)
+{
+    return i & (~i + 1);
+}
+
+/// @brief Applies a change of weight to a slot of a Fenwick tree.
+///
+/// @param tree The Fenwick tree.
+/// @param slot The slot to change.
+/// @param previous The previous weight of the slot.
+/// @param current The new weight of the slot.
+static inline void fenwick_update(robsec::ArenaVector<std::size_t> &tree, std::size_t slot, std::size_t previous, std::size_t current)
+{
+    // Unsigned arithmetic wraps around, so the difference can be applied as it is.
+    for (std::size_t i = slot + 1; i < tree.size(); i += lowest_bit(i)) {
+        tree[i] = tree[i] - previous + current;
+    }
+}
+
+namespace robsec
+{
+
+FreeSpaceIndex::FreeSpaceIndex(Arena &arena)
+    : span(1),
+      max_slots(0),
+      capacity(0),
+      slots(ArenaAllocator<Interval>(arena)),
+      loose(ArenaAllocator<std::size_t>(arena)),
+      tight(ArenaAllocator<std::size_t>(arena))
+{
+    // Nothing to do.
+}
+
+void FreeSpaceIndex::reset(std::size_t n_panels, std::size_t n_cells, std::size_t _span, std::size_t max_spans)
+{
+    span = _span;
+    // Each occupied span splits one interval in two, so it adds at most one slot.
+    max_slots = n_panels + max_spans;
+    capacity  = 0;
+    slots.clear();
+    slots.reserve(max_slots);
+    loose.assign(max_slots + 1, 0);
+    tight.assign(max_slots + 1, 0);
+    for (std::size_t panel = 0; panel < n_panels; ++panel) {
+        this->push(Interval{ panel, 0, n_cells });
+    }
+}
+
+std::size_t FreeSpaceIndex::get_capacity() const
+{
+    return capacity;
+}
+
+bool FreeSpaceIndex::occupy_random(RandomEngine &engine, std::size_t remaining, std::size_t &panel, std::size_t &start)
+{
+    if ((remaining == 0) || (capacity < remaining) || (slots.size() >= max_slots)) {
+        return false;
+    }
+    // With no room to spare, a start that wastes room would leave one of
+    // the remaining spans without a place, so only tight starts are valid.
+    bool strict = (capacity == remaining);
+    const ArenaVector<std::size_t> &tree = strict ? tight : loose;
+    // Pick a valid start, and find the interval it belongs to.
+    std::size_t offset = random_number<std::size_t>(engine, 0, this->total(tree) - 1);
+    std::size_t slot   = this->find(tree, offset);
+    Interval interval  = slots[slot];
+    if (strict) {
+        // The tight starts are the first (length % span + 1) of every block of span cells.
+        std::size_t block = (interval.end - interval.begin) % span + 1;
+        offset            = (offset / block) * span + offset % block;
+    }
+    panel = interval.panel;
+    start = interval.begin + offset;
+    // Split the interval around the span.
+    this->update(slot, Interval{ interval.panel, interval.begin, start });
+    this->push(Interval{ interval.panel, start + span, interval.end });
+    return true;
+}
+
+void FreeSpaceIndex::push(const Interval &interval)
+{
+    slots.push_back(Interval{ interval.panel, interval.begin, interval.begin });
+    this->update(slots.size() - 1, interval);
+}
+
+void FreeSpaceIndex::update(std::size_t slot, const Interval &interval)
+{
+    const Interval &previous = slots[slot];
+    fenwick_update(loose, slot, this->loose_weight(previous), this->loose_weight(interval));
+    fenwick_update(tight, slot, this->tight_weight(previous), this->tight_weight(interval));
+    capacity = capacity - (previous.end - previous.begin) / span + (interval.end - interval.begin) / span;
+    slots[slot] = interval;
+}
+
+std::size_t FreeSpaceIndex::loose_weight(const Interval &interval) const
+{
+    std::size_t length = interval.end - interval.begin;
+    return (length >= span) ? (length - span + 1) : 0;
+}
+
+std::size_t FreeSpaceIndex::tight_weight(const Interval &interval) const
+{
+    // A start wastes no room when the cells left before it, modulo the span,
+    // do not exceed the cells the interval has beyond a multiple of the span.
+    std::size_t length = interval.end - interval.begin;
+    return (length / span) * (length % span + 1);
+}
+
+std::size_t FreeSpaceIndex::total(const ArenaVector<std::size_t> &tree) const
+{
+    std::size_t sum = 0;
+    for (std::size_t i = max_slots; i > 0; i -= lowest_bit(i)) {
+        sum += tree[i];
+    }
+    return sum;
+}
+
+std::size_t FreeSpaceIndex::find(const ArenaVector<std::size_t> &tree, std::size_t &offset) const
+{
+    // Standard Fenwick descent, from the highest power of two.
+    std::size_t position = 0, step = 1;
+    while ((step << 1) <= max_slots) {
+        step <<= 1;
+    }
+    for (; step > 0; step >>= 1) {
+        if ((position + step <= max_slots) && (tree[position + step] <= offset)) {
+            position += step;
+            offset -= tree[position];
+        }
+    }
+    return position;
+}
+
+} // namespace robsec
@@ -3,582 +3,909 @@
 /// @brief
 
 #include "robsec/game.hpp"
+#include "robsec/allocation_counter.hpp"
+#include "robsec/render_target.hpp"
+#include "robsec/snapshot.hpp"
+#include "robsec/varint.hpp"
 
 #include <cstdint>
 #include <curses.h>
 
 #include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
 #include <cstring>
-#include <fstream>
-#include <iomanip>
 #include <iostream>
-#include <random>
 #include <string>
 
-/// @brief Length of an address in the game.
-#define ADDRESS_LEN 6
+/// @brief Lines of the header displayed at the start of the game.
+static const char *const header[] = { "ROBCO INDUSTRIES (TM) TERMLINK PROTOCOL", "ENTER PASSWORD NOW" };
 
-/// @brief Header displayed at the start of the game.
-#define HEADER                                  \
-    "ROBCO INDUSTRIES (TM) TERMLINK PROTOCOL\n" \
-    "ENTER PASSWORD NOW\n"                      \
-    "\n"
+/// @brief Prompt displayed below the panels, while playing and once the round is over.
+static const char *const prompts[] = { "Press 'q' to exit",
+                                       "Terminal unlocked. Press 'r' to replay or 'q' to exit",
+                                       "Terminal locked. Press 'r' to replay or 'q' to exit",
+                                       "Dud removed. Press 'q' to exit",
+                                       "Tries reset. Press 'q' to exit" };
 
-/// @brief Length of the header in terms of newlines and additional spacing.
-#define HEADER_LEN (3 + 2)
+/// @brief Number of characters typed at each tick of the animation.
+#define TYPED_PER_TICK 1
+
+/// @brief Size of the buffer of a typed line, with its terminator.
+#define TYPED_LINE_SIZE 128
+
+/// @brief One bracket pair out of this many replenishes the attempts instead of removing a dud.
+#define RESET_ODDS 5
 
 /// @brief Macro to check the result of an expression and return false if it fails.
 #define CHECK_AND_REPORT(expr, msg)                     \
     do {                                                \
-        if ((expr) == ERR) {                            \
+        if (!(expr)) {                                  \
             std::cerr << "Error: " << msg << std::endl; \
             return false;                               \
         }                                               \
     } while (0)
 
-/// @brief Generates a random number within the specified range.
-///
-/// @tparam T The type of the range values (e.g., int, float).
-/// @param min The minimum value of the range (inclusive).
-/// @param max The maximum value of the range (inclusive).
-/// @return A random number of type T within the specified range.
-template <typename T>
-static inline T random_number(T min, T max)
-{
-    // Random device used to seed the generator.
-    std::random_device seeder;
-    // Mersenne Twister engine for generating random numbers.
-    std::mt19937 engine(seeder());
-    // Uniform distribution for numbers within the given range.
-    std::uniform_int_distribution<T> dist(min, max);
-    return dist(engine); // Generate and return the random number.
-}
-
-/// @brief Generates a random string of garbage characters.
+/// @brief Returns the milliseconds left until the given time, rounded up.
 ///
-/// @param width The length of the string to generate.
-/// @return A string containing random garbage characters.
-static inline std::string generate_garbage_string(std::size_t width)
+/// @param deadline The time.
+/// @return The milliseconds, 0 if the time has passed.
+static inline int milliseconds_until(const std::chrono::steady_clock::time_point &deadline)
 {
-    // Set of characters to use for generating the garbage string.
-    static const char *garbage = ",|\\!@#$%^&*-_+=.:;?,/";
-    std::string s;
-
-    // Generate a random character for each position in the string.
-    for (std::size_t i = 0; i < width; ++i) {
-        // Select a random character from the garbage array.
-        s.push_back(garbage[random_number<std::size_t>(0, std::strlen(garbage) - 1)]);
+    std::chrono::steady_clock::duration left = deadline - std::chrono::steady_clock::now();
+    if (left <= std::chrono::steady_clock::duration::zero()) {
+        return 0;
     }
-
-    return s; // Return the generated garbage string.
+    return static_cast<int>((std::chrono::duration_cast<std::chrono::microseconds>(left).count() + 999) / 1000);
 }
 
-/// @brief Selects a random iterator within a specified range, using a custom random generator.
+/// @brief Reads an input from ncurses, with the position of the mouse for mouse events.
 ///
-/// @tparam Iter Type of the iterator.
-/// @tparam RandomGenerator Type of the random generator.
-/// @param start Iterator to the beginning of the range.
-/// @param end Iterator to the end of the range.
-/// @param g Reference to a random generator.
-/// @return A randomly selected iterator within the range.
-template <typename Iter, typename RandomGenerator>
-static inline Iter select_randomly(Iter start, Iter end, RandomGenerator &g)
-{
-    using type_t = typename Iter::difference_type;
-    type_t ub    = std::distance(start, end) - 1;
-    if (ub > 0) {
-        // Create a uniform distribution within the range.
-        std::uniform_int_distribution<type_t> dis(0, ub);
-        // Advance the start iterator by a random offset.
-        std::advance(start, dis(g));
-    }
-    return start; // Return the randomly selected iterator.
-}
-
-/// @brief Selects a random iterator within a specified range, using a static random generator.
-///
-/// @tparam Iter Type of the iterator.
-/// @param start Iterator to the beginning of the range.
-/// @param end Iterator to the end of the range.
-/// @return A randomly selected iterator within the range.
-template <typename Iter>
-static inline Iter select_randomly(Iter start, Iter end)
+/// @param event Receives the input.
+/// @return true on success, false if there is no input.
+static inline bool read_input(robsec::InputEvent &event)
 {
-    // Static random device and generator to avoid re-initialization.
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    return select_randomly(start, end, gen); // Use the overloaded version.
+    event.key = getch();
+    event.x   = -1;
+    event.y   = -1;
+    if (event.key == ERR) {
+        return false;
+    }
+    MEVENT mouse;
+    if ((event.key == KEY_MOUSE) && (getmouse(&mouse) == OK)) {
+        event.x = mouse.x;
+        event.y = mouse.y;
+    }
+    return true;
 }
 
-/// @brief Modifies a string by applying a transformation function to each character.
+/// @brief Makes room for the given number of characters in a growable buffer.
 ///
-/// @tparam T Type of the transformation function.
-/// @param s Reference to the string to be modified.
-/// @param fun Function pointer to the transformation function.
-/// @return Reference to the modified string.
-template <typename T>
-static inline std::string &string_modifier(std::string &s, T (*fun)(T))
+/// @param buffer The buffer.
+/// @param size The number of characters.
+static inline void fit_buffer(std::vector<char> &buffer, std::size_t size)
 {
-    // Apply the transformation function to each character in the string.
-    for (auto &c : s) {
-        c = static_cast<char>(fun(c));
-    }
-    return s; // Return the modified string.
+    buffer.resize(size);
 }
 
-/// @brief Counts the number of common letters between two C-style strings.
-///
-/// @param a Pointer to the first string.
-/// @param b Pointer to the second string.
-/// @return The count of common letters between the two strings.
-static inline int count_common_letters(const char *a, const char *b)
+/// @brief Does nothing, a fixed buffer is sized by its layout.
+template <std::size_t N>
+static inline void fit_buffer(std::array<char, N> &, std::size_t)
 {
-    int table[256] = { 0 }; // Frequency table for characters in 'a'.
-    int result     = 0;     // Counter for common characters.
-
-    // Populate the frequency table with characters from 'a'.
-    for (; *a; a++) {
-        table[static_cast<unsigned char>(*a)]++;
-    }
-
-    // Count matching characters from 'b' in the frequency table.
-    for (; *b; b++) {
-        result += (table[static_cast<unsigned char>(*b)]-- > 0);
-    }
-
-    return result; // Return the count of common letters.
 }
 
 namespace robsec
 {
 
-Game::Game(std::string _dictionary_path,
-           std::size_t _n_panels,
-           std::size_t _n_rows,
-           std::size_t _n_columns,
-           std::size_t _n_words,
-           int _attempts_max)
-    : dictionary_path(_dictionary_path),
-      dictionary(),
-      start_address(0),
-      n_panels(_n_panels),
-      n_rows(_n_rows),
-      n_columns(_n_columns),
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+BasicGame<Panels, Rows, Columns>::BasicGame(RenderTarget &_target,
+                                            std::shared_ptr<const Dictionary> _dictionary,
+                                            std::size_t _n_panels,
+                                            std::size_t _n_rows,
+                                            std::size_t _n_columns,
+                                            std::size_t _n_words,
+                                            int _attempts_max,
+                                            unsigned _seed,
+                                            BoardPrefetcher *_prefetcher)
+    : target(_target),
+      dictionary(_dictionary),
+      layout(_n_panels, _n_rows, _n_columns),
       n_words(_n_words),
       attempts_max(_attempts_max),
       attempts(attempts_max),
       position({ 0, 0, 0 }),
-      solution(),
-      words(),
-      content(),
-      state(Running)
+      generator(*dictionary, _n_panels, _n_rows, _n_columns, n_words),
+      prefetcher(_prefetcher),
+      board(),
+      state(Running),
+      feedback(),
+      removed(),
+      notice(0),
+      animated(false),
+      typed(0),
+      scrolled(0),
+      solver(),
+      painted(),
+      addresses(),
+      max_frame_allocations(0),
+      stats(nullptr),
+      seed(resolve_seed(_seed)),
+      engine(seed),
+      tricks()
 {
     // Nothing to do.
 }
 
-bool Game::initialize()
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+bool BasicGame<Panels, Rows, Columns>::initialize()
 {
-    // Load the dictionary.
-    if (!this->load_dictionary()) {
-        std::cerr << "Error: Failed to load the dictionary." << std::endl;
+    // Generate the first board.
+    if (!this->prepare_round(stats ? &stats->generation : nullptr)) {
         return false;
     }
 
-    // Ensure the sorted dictionary is not empty.
-    if (sorted_dictionary.empty()) {
-        std::cerr << "Error: The sorted dictionary is empty after loading." << std::endl;
+    // Prepare the target.
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    if (!target.start()) {
+        std::cerr << "Error: Failed to start the render target." << std::endl;
         return false;
     }
+    std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
 
-    // Get a random dictionary group.
-    const DictionaryGroup *dictionary = nullptr;
-    try {
-        dictionary = &(*select_randomly(sorted_dictionary.begin(), sorted_dictionary.end()));
-    } catch (const std::exception &e) {
-        std::cerr << "Error: Failed to select a random dictionary group. Exception: " << e.what() << std::endl;
-        return false;
-    }
-
-    // Ensure the dictionary group contains words.
-    if (dictionary->words.empty()) {
-        std::cerr << "Error: The selected dictionary group contains no words." << std::endl;
+    // Render the scene, with the cursor at the beginning.
+    if (!this->render() || !this->present()) {
+        std::cerr << "Error: Failed to render the game scene." << std::endl;
+        target.stop();
         return false;
     }
 
-    // Create a mutable copy of the dictionary group's words for selection.
-    std::vector<std::string> selection = dictionary->words;
-
-    // Ensure we don't attempt to place more words than are available.
-    int total_words = std::min(static_cast<int>(n_words), static_cast<int>(selection.size()));
-
-    // Ensure there are words to place.
-    if (total_words == 0) {
-        std::cerr << "Error: No words available to place after adjustments." << std::endl;
-        return false;
+    if (stats) {
+        stats->target_start = elapsed_s(begin, started);
+        stats->first_frame  = elapsed_s(started, std::chrono::steady_clock::now());
     }
+    return true;
+}
 
-    // Keep track of the round.
-    int round = 100;
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+void BasicGame<Panels, Rows, Columns>::set_stats(GameStats *_stats)
+{
+    stats = _stats;
+}
 
-    // Place the words.
-    while (total_words && round) {
-        // Get a random index and word from the selection.
-        std::size_t index  = random_number<std::size_t>(0, selection.size() - 1);
-        std::string string = selection[index];
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+void BasicGame<Panels, Rows, Columns>::set_difficulty(const LikenessIndex *_index, Difficulty _difficulty)
+{
+    generator.set_difficulty(_index, _difficulty);
+}
 
-        // Prepare the word object.
-        Word word(0, 0, string);
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+void BasicGame<Panels, Rows, Columns>::set_animated(bool _animated)
+{
+    animated = _animated;
+}
 
-        // Check if we already selected this word.
-        if (std::find(words.begin(), words.end(), word) == words.end()) {
-            // Find a random place.
-            if (this->find_unoccupied_space_for_word(word)) {
-                total_words--;                                                 // Decrease the count of words to place.
-                words.emplace_back(word);                                      // Add the word to the placed words list.
-                selection.erase(selection.begin() + static_cast<long>(index)); // Remove the word from the selection.
-                continue;                                                      // Skip the rest of the loop for this iteration.
-            }
-        }
-        // Decrease the round count to prevent infinite loops.
-        round--;
-    }
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+bool BasicGame<Panels, Rows, Columns>::is_animating() const
+{
+    return animated && (typed < this->count_typed());
+}
 
-    // Check if the placement process failed.
-    if (round == 0) {
-        std::cerr << "Error: Failed to place all words within the allowed rounds." << std::endl;
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+bool BasicGame<Panels, Rows, Columns>::tick(std::size_t n_ticks)
+{
+    if (!this->is_animating()) {
         return false;
     }
+    // Type the next characters, skipping the missed ticks if it is late.
+    typed = std::min(typed + n_ticks * TYPED_PER_TICK, this->count_typed());
+    this->render();
+    this->present();
+    return this->is_animating();
+}
 
-    // Ensure there are words placed in the game.
-    if (words.empty()) {
-        std::cerr << "Error: No words were placed in the game." << std::endl;
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+bool BasicGame<Panels, Rows, Columns>::new_round()
+{
+    // Generate the new board, in the buffers of the previous one.
+    if (!this->prepare_round(nullptr)) {
         return false;
     }
 
-    // Choose the solution.
-    std::size_t solution_idx = random_number<std::size_t>(0, words.size() - 1);
-    solution                 = words[solution_idx].string;
-
-    // Seed the random number generator.
-    std::srand(static_cast<unsigned>(std::time(NULL)));
-
-    // Compute the starting address.
-    start_address = random_number<std::size_t>(0xA000, 0xFFFF - n_rows * n_panels * n_columns);
+    // Repaint the whole scene, with the cursor at the beginning.
+    painted = Painted();
+    return this->render() && this->present();
+}
 
-    // Initialize NCurses.
-    if (initscr() == nullptr) {
-        std::cerr << "Error: Failed to initialize NCurses." << std::endl;
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+bool BasicGame<Panels, Rows, Columns>::serialize(std::vector<char> &buffer) const
+{
+    if (!serialize_board(*dictionary, board, buffer)) {
         return false;
     }
-
-    // Clear the screen.
-    if (clear() == ERR) {
-        std::cerr << "Error: Failed to clear the screen in NCurses." << std::endl;
-        endwin();
-        return false;
+    // A pending guess is applied before rendering, so it is never saved.
+    write_varint(buffer, seed);
+    write_varint(buffer, static_cast<uint64_t>(attempts_max));
+    write_varint(buffer, static_cast<uint64_t>(attempts));
+    write_varint(buffer, (state == Won) ? 1 : ((state == Lost) ? 2 : 0));
+    write_varint(buffer, position.panel);
+    write_varint(buffer, position.row);
+    write_varint(buffer, position.column);
+    write_varint(buffer, static_cast<uint64_t>(notice));
+    write_varint(buffer, feedback.size());
+    for (const Feedback &guess : feedback) {
+        write_varint(buffer, guess.word);
     }
+    return true;
+}
 
-    // Disable echo.
-    if (noecho() == ERR) {
-        std::cerr << "Error: Failed to disable echo in NCurses." << std::endl;
-        endwin();
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+bool BasicGame<Panels, Rows, Columns>::deserialize(const char *data, std::size_t size)
+{
+    // Read everything aside, so that the round is left as it is on failure.
+    std::size_t offset = 0;
+    Board restored;
+    if (!deserialize_board(*dictionary, data, size, offset, restored)) {
         return false;
     }
-
-    // Enable cbreak mode.
-    if (cbreak() == ERR) {
-        std::cerr << "Error: Failed to enable cbreak mode in NCurses." << std::endl;
-        endwin();
+    if ((restored.n_panels != layout.get_n_panels()) || (restored.n_rows != layout.get_n_rows()) || (restored.n_columns != layout.get_n_columns())) {
+        std::cerr << "Error: The snapshot has a different layout." << std::endl;
         return false;
     }
-
-    // Enable keypad input for the main window.
-    if (keypad(stdscr, true) == ERR) {
-        std::cerr << "Error: Failed to enable keypad input in NCurses." << std::endl;
-        endwin();
-        return false;
+    uint64_t values[9];
+    for (uint64_t &value : values) {
+        if (!read_varint(data, size, offset, value)) {
+            std::cerr << "Error: The snapshot is truncated." << std::endl;
+            return false;
+        }
     }
-
-    // Initialize colors in NCurses.
-    if (start_color() == ERR) {
-        std::cerr << "Error: Failed to initialize colors in NCurses." << std::endl;
-        endwin();
+    const uint64_t snapshot_seed = values[0], max = values[1], left = values[2], outcome = values[3], panel = values[4], row = values[5], column = values[6], prompt = values[7], n_guesses = values[8];
+    if ((max != static_cast<uint64_t>(attempts_max)) || ((left == 0) != (outcome == 2)) || (left > max) || (outcome > 2) || (panel >= layout.get_n_panels()) ||
+        (row >= layout.get_n_rows()) || (column >= layout.get_n_columns()) || ((prompt != 0) && (prompt != 3) && (prompt != 4)) || (n_guesses >= restored.get_n_words())) {
+        std::cerr << "Error: The snapshot has an invalid round." << std::endl;
         return false;
     }
-
-    // Enable support for default background color.
-    if (use_default_colors() == ERR) {
-        std::cerr << "Error: Failed to enable default terminal background color." << std::endl;
-        endwin();
-        return false;
+    std::vector<Feedback> guesses;
+    guesses.reserve(static_cast<std::size_t>(n_guesses));
+    for (uint64_t i = 0; i < n_guesses; ++i) {
+        uint64_t word;
+        if (!read_varint(data, size, offset, word) || (word >= restored.get_n_words()) || (word == restored.solution_index) ||
+            std::any_of(guesses.begin(), guesses.end(), [word](const Feedback &guess) { return guess.word == word; })) {
+            std::cerr << "Error: The snapshot has an invalid guess." << std::endl;
+            return false;
+        }
+        guesses.push_back(Feedback{ static_cast<std::size_t>(word), restored.likeness.at(static_cast<std::size_t>(word), restored.solution_index) });
+    }
+
+    // Resume the round.
+    std::swap(board, restored);
+    seed     = static_cast<unsigned>(snapshot_seed);
+    attempts = static_cast<int>(left);
+    state    = (outcome == 1) ? Won : ((outcome == 2) ? Lost : Running);
+    position = GameLocation(static_cast<std::size_t>(panel), static_cast<std::size_t>(column), static_cast<std::size_t>(row));
+    notice   = static_cast<int>(prompt);
+    feedback.swap(guesses);
+    engine.seed(seed ^ static_cast<unsigned>(board.start_address << 8 | board.solution_index));
+    this->seed_tricks();
+
+    // Narrow the candidates as the guesses and the removed duds did.
+    solver.reset(board.likeness);
+    removed.clear();
+    for (std::size_t i = 0; i < board.get_n_words(); ++i) {
+        if (board.is_removed(i)) {
+            removed.push_back(static_cast<uint32_t>(i));
+            solver.remove(i);
+        }
     }
-
-    // Define a color pair for yellow text with a transparent (default) background.
-    if (init_pair(1, COLOR_YELLOW, -1) == ERR) {
-        std::cerr << "Error: Failed to define color pair 1 (yellow on default background)." << std::endl;
-        endwin();
-        return false;
+    for (const Feedback &guess : feedback) {
+        solver.observe(guess.word, guess.likeness);
     }
 
-    // Initialize the panel content.
-    try {
-        content.resize(n_panels);
-    } catch (const std::exception &e) {
-        std::cerr << "Error: Failed to resize content vector. Exception: " << e.what() << std::endl;
-        endwin();
-        return false;
+    // Format the addresses of the new board, and repaint everything at once.
+    this->format_addresses();
+    scrolled = (feedback.size() > static_cast<std::size_t>(attempts_max)) ? feedback.size() - static_cast<std::size_t>(attempts_max) : 0;
+    painted  = Painted();
+    typed    = this->count_typed();
+    return this->render() && this->present();
+}
+
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+void BasicGame<Panels, Rows, Columns>::stop()
+{
+    target.stop();
+}
+
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+bool BasicGame<Panels, Rows, Columns>::run(bool coalesce, InputRecorder *recorder)
+{
+    InputEvent events[64];
+    bool quit = false;
+    std::chrono::steady_clock::time_point arrival;
+    // The ticks of the animation follow a fixed grid, started with the animation.
+    const std::chrono::steady_clock::duration period = std::chrono::milliseconds(ANIMATION_TICK_MS);
+    std::chrono::steady_clock::time_point next_tick;
+    bool ticking = false;
+    mousemask(ALL_MOUSE_EVENTS, NULL);
+    while (!quit) {
+        // Block until an input, or until the next tick while animating.
+        bool animating = this->is_animating();
+        if (animating && !ticking) {
+            next_tick = std::chrono::steady_clock::now() + period;
+        }
+        ticking = animating;
+        timeout(animating ? milliseconds_until(next_tick) : -1);
+
+        // Take the ones already pending, if coalescing.
+        std::size_t n_events = 0;
+        while (read_input(events[n_events])) {
+            // The latency of the frame starts with its first input.
+            if (stats && (n_events == 0)) {
+                arrival = std::chrono::steady_clock::now();
+            }
+            if (events[n_events].key == 'q') {
+                quit = true;
+                break;
+            }
+            if (recorder) {
+                recorder->record(events[n_events]);
+            }
+            if ((++n_events == 64) || !coalesce) {
+                break;
+            }
+            timeout(0);
+        }
+        // The input is handled right away, even in the middle of the animation.
+        if (n_events > 0) {
+            this->handle_input(events, n_events);
+            if (stats) {
+                stats->input_latency.record(elapsed_ns(arrival, std::chrono::steady_clock::now()));
+            }
+        }
+
+        // Advance the animation by the ticks which are due, if any.
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (animating && (now >= next_tick)) {
+            std::size_t n_ticks = 1 + static_cast<std::size_t>((now - next_tick) / period);
+            next_tick += n_ticks * period;
+            this->tick(n_ticks);
+        }
     }
+    timeout(-1);
+    return this->has_won();
+}
 
-    // Fill the panel content with garbage strings.
-    try {
-        for (std::size_t c = 0; c < n_panels; ++c) {
-            content[c] = generate_garbage_string(n_rows * n_columns);
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+bool BasicGame<Panels, Rows, Columns>::handle_key(int key)
+{
+    InputEvent event{ key, -1, -1 };
+    return this->handle_input(&event, 1);
+}
+
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+bool BasicGame<Panels, Rows, Columns>::handle_input(const InputEvent *events, std::size_t n_events)
+{
+    // Apply all the events in order, then render a single frame.
+    for (std::size_t i = 0; i < n_events; ++i) {
+        this->apply_input(events[i]);
+    }
+    std::size_t allocations = allocation_count();
+    // Render what changed in the scene, and show it. The clock is read only
+    // when collecting the statistics.
+    std::chrono::steady_clock::time_point begin, rendered;
+    if (stats) {
+        begin = std::chrono::steady_clock::now();
+    }
+    this->render();
+    if (stats) {
+        rendered = std::chrono::steady_clock::now();
+    }
+    this->present();
+    // Keep track of the allocations done while painting.
+    allocations           = allocation_count() - allocations;
+    max_frame_allocations = std::max(max_frame_allocations, allocations);
+    if (stats) {
+        stats->render_time.record(elapsed_ns(begin, rendered));
+        stats->present_time.record(elapsed_ns(rendered, std::chrono::steady_clock::now()));
+        stats->frame_allocations.record(allocations);
+    }
+    return !this->is_over();
+}
+
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+void BasicGame<Panels, Rows, Columns>::apply_input(const InputEvent &event)
+{
+    // Once the round is over, the only way forward is a new round.
+    if (this->is_over()) {
+        if ((event.key == 'r') && this->prepare_round(nullptr)) {
+            painted = Painted();
         }
-    } catch (const std::exception &e) {
-        std::cerr << "Error: Failed to generate garbage strings for panel content. Exception: " << e.what() << std::endl;
-        endwin();
-        return false;
+        return;
     }
+    // Parse the input.
+    this->parse_input(event);
+    // Apply the guess, if any.
+    this->update();
+}
 
-    // Render the scene.
-    if (!this->render()) {
-        std::cerr << "Error: Failed to render the game scene." << std::endl;
-        endwin();
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+bool BasicGame<Panels, Rows, Columns>::prepare_round(GenerationTimings *timings)
+{
+    // Take a ready board, or generate it.
+    if (prefetcher ? !prefetcher->pop(board) : !generator.generate(board, engine, timings)) {
+        std::cerr << "Error: Failed to generate the board." << std::endl;
         return false;
     }
 
-    // Move the cursor to the beginning.
-    this->move_cursor_to(0, 0, 0);
+    // Start a new round, from the beginning.
+    state    = Running;
+    attempts = attempts_max;
+    position = GameLocation(0, 0, 0);
+    notice   = 0;
+    typed    = 0;
+    scrolled = 0;
+    feedback.clear();
+    removed.clear();
+
+    // Start solving the new board, with its own draws for the bracket pairs.
+    solver.reset(board.likeness);
+    this->seed_tricks();
 
+    // Format the addresses once, for the whole round.
+    this->format_addresses();
     return true;
 }
 
-void Game::stop()
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+void BasicGame<Panels, Rows, Columns>::seed_tricks()
 {
-    endwin();
+    std::seed_seq sequence{ seed, static_cast<unsigned>(board.start_address), static_cast<unsigned>(board.solution_index), board.word_ids[board.solution_index] };
+    tricks.seed(sequence);
 }
 
-bool Game::run()
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+void BasicGame<Panels, Rows, Columns>::format_addresses()
 {
-    mousemask(ALL_MOUSE_EVENTS, NULL);
-    for (int ch = getch(); ch != 'q'; ch = getch()) {
-        // Parse the input.
-        this->parse_input(ch);
-        // Render the scene.
-        this->render();
-        // Move the cursor.
-        this->move_cursor_to(position);
-        refresh();
-        if (state == Won) {
-            return true;
-        }
-        if (state == Lost) {
-            return false;
+    // Row after row and panel after panel.
+    fit_buffer(addresses, layout.get_n_rows() * layout.get_n_panels() * (ADDRESS_LEN + 1) + 1);
+    for (std::size_t r = 0; r < layout.get_n_rows(); ++r) {
+        for (std::size_t c = 0; c < layout.get_n_panels(); ++c) {
+            std::snprintf(&addresses[(r * layout.get_n_panels() + c) * (ADDRESS_LEN + 1)], ADDRESS_LEN + 2, "0x%04zX ", this->compute_address(r, c));
         }
     }
-    return false;
 }
 
-bool Game::render()
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+void BasicGame<Panels, Rows, Columns>::update()
 {
-    // Find the currently selected word.
-    const Word *selected_word = this->find_selected_word();
-    if (!selected_word && ((state == MousePressed) || (state == EnterPressed))) {
-        std::cerr << "Error: No word is selected, but input was detected." << std::endl;
-        return false;
+    // Check if we just pressed Enter or the mouse.
+    if ((state != MousePressed) && (state != EnterPressed)) {
+        return;
+    }
+    state = Running;
+
+    // Find the currently selected word, or use the bracket pair under the cursor.
+    uint32_t index = this->find_selected_word();
+    if (index == Board::no_word) {
+        this->apply_pair();
+        return;
+    }
+    notice = 0;
+
+    if (index == board.solution_index) {
+        state = Won;
+        return; // Exit early if the correct solution is found.
     }
 
-    int common_letters = 0;
+    // Read the common letters from the likeness matrix.
+    int common_letters = board.likeness.at(index, board.solution_index);
 
-    // Check if we just pressed Enter or the mouse.
-    if (selected_word && ((state == MousePressed) || (state == EnterPressed))) {
-        if (selected_word->string == solution) {
-            state = Won;
-            return true; // Exit early if the correct solution is found.
+    // Decrease attempts and check if the game is lost.
+    if (--attempts == 0) {
+        state = Lost;
+        return; // Game ends when attempts run out.
+    }
+
+    // A word guessed again costs an attempt, but its feedback is already logged.
+    for (const Feedback &guess : feedback) {
+        if (guess.word == index) {
+            return;
         }
+    }
 
-        // Count common letters.
-        common_letters = count_common_letters(selected_word->string.c_str(), solution.c_str());
+    // Queue the feedback for the guess, and narrow the candidates.
+    feedback.push_back(Feedback{ index, common_letters });
+    solver.observe(index, common_letters);
+    this->scroll_feedback();
+}
 
-        // Decrease attempts and check if the game is lost.
-        if (--attempts == 0) {
-            state = Lost;
-            return true; // Game ends when attempts run out.
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+void BasicGame<Panels, Rows, Columns>::scroll_feedback()
+{
+    // Once a bracket pair replenished the attempts, there can be more wrong
+    // guesses than rows: drop the oldest ones from the log, with their
+    // typed characters, which keeps the header and the lines still shown.
+    const std::size_t header_length = std::strlen(header[0]) + std::strlen(header[1]);
+    while (feedback.size() - scrolled > static_cast<std::size_t>(attempts_max)) {
+        char buffer[TYPED_LINE_SIZE];
+        std::size_t dropped = 0, length = 0;
+        int x, y;
+        for (std::size_t line = 2; line < 4; ++line) {
+            if (!this->get_typed_line(line, buffer, length, x, y)) {
+                break;
+            }
+            dropped += length;
         }
+        typed = (typed > header_length + dropped) ? typed - dropped : std::min(typed, header_length);
+        ++scrolled;
     }
+}
 
-    // Check if the cursor movement fails.
-    if (wmove(stdscr, 0, 0) == ERR) {
-        std::cerr << "Error: Failed to move the cursor to the beginning." << std::endl;
-        return false;
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+void BasicGame<Panels, Rows, Columns>::apply_pair()
+{
+    std::size_t cell = this->find_selected_pair();
+    if (cell == SIZE_MAX) {
+        return;
     }
+    board.consume_pair(position.panel, position.row * layout.get_n_columns() + position.column);
 
-    // Print the header.
-    if (printw(HEADER) == ERR) {
-        std::cerr << "Error: Failed to print the game header." << std::endl;
-        return false;
+    // Count the duds still on the board.
+    std::size_t n_duds = 0;
+    for (std::size_t i = 0; i < board.get_n_words(); ++i) {
+        n_duds += ((i != board.solution_index) && !board.is_removed(i)) ? 1 : 0;
     }
 
-    // Print attempts.
-    if (printw("%d ATTEMPT(S) LEFT :", attempts) == ERR) {
-        std::cerr << "Error: Failed to print the remaining attempts." << std::endl;
-        return false;
+    // Replenish the attempts once in a while, or when there is no dud left;
+    // there is nothing to replenish while all the attempts are left.
+    if ((n_duds == 0) || ((attempts < attempts_max) && (random_number<int>(tricks, 0, RESET_ODDS - 1) == 0))) {
+        attempts = attempts_max;
+        notice   = 4;
+        return;
     }
-    for (int i = 0; i < attempts; ++i) {
-        if (printw(" #") == ERR) {
-            std::cerr << "Error: Failed to print the attempt marker." << std::endl;
-            return false;
+
+    // Remove a random dud.
+    std::size_t pick = random_number<std::size_t>(tricks, 0, n_duds - 1);
+    for (std::size_t i = 0; i < board.get_n_words(); ++i) {
+        if ((i == board.solution_index) || board.is_removed(i)) {
+            continue;
+        }
+        if (pick-- == 0) {
+            board.remove_word(i);
+            solver.remove(i);
+            removed.push_back(static_cast<uint32_t>(i));
+            break;
         }
     }
-    if (printw("\n\n") == ERR) {
-        std::cerr << "Error: Failed to print the attempts separator." << std::endl;
-        return false;
+    notice = 3;
+}
+
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+bool BasicGame<Panels, Rows, Columns>::render()
+{
+    // Paint the static part of the scene, only once.
+    if (!painted.scene) {
+        if (!this->render_scene()) {
+            return false;
+        }
+        painted.scene     = true;
+        painted.attempts  = -1;
+        painted.selection = Board::no_word;
+        painted.pair      = SIZE_MAX;
+        painted.removed   = removed.size();
+        painted.typed     = 0;
+        painted.scrolled  = scrolled;
+    }
+
+    // Repaint the log from its top, once it scrolled.
+    if (painted.scrolled != scrolled) {
+        if (!this->clear_feedback()) {
+            return false;
+        }
+        painted.typed    = std::min(painted.typed, std::strlen(header[0]) + std::strlen(header[1]));
+        painted.scrolled = scrolled;
     }
 
-    std::size_t address;
-    for (std::size_t r = 0; r < n_rows; ++r) {
-        for (std::size_t c = 0; c < n_panels; ++c) {
-            // Compute the address.
-            address = this->compute_address(r, c);
+    // Repaint the attempts, if they changed.
+    if (painted.attempts != attempts) {
+        if (!this->render_attempts()) {
+            return false;
+        }
+        painted.attempts = attempts;
+    }
 
-            // Print the address.
-            if (printw("0x%04zX ", address) == ERR) {
-                std::cerr << "Error: Failed to print the address for row " << r << ", panel " << c << "." << std::endl;
-                return false;
-            }
+    // Paint the duds removed since the last frame as garbage.
+    for (; painted.removed < removed.size(); ++painted.removed) {
+        std::size_t index = removed[painted.removed];
+        if (!this->render_garbage(board.word_panels[index] * layout.get_n_rows() * layout.get_n_columns() + board.word_starts[index], board.get_word_length(), Normal)) {
+            return false;
+        }
+    }
 
-            // Print the content.
-            if (printw("%s", content[c].substr(r * n_columns, n_columns).c_str()) == ERR) {
-                std::cerr << "Error: Failed to print the panel content for row " << r << ", panel " << c << "." << std::endl;
+    // Repaint the previously selected bracket pair and the new one, if they differ.
+    std::size_t pair = this->find_selected_pair();
+    if (painted.pair != pair) {
+        if ((painted.pair != SIZE_MAX) && !this->render_garbage(painted.pair, painted.pair_length, Normal)) {
+            return false;
+        }
+        if (pair != SIZE_MAX) {
+            painted.pair_length = board.pairs[pair];
+            if (!this->render_garbage(pair, painted.pair_length, Reversed)) {
                 return false;
             }
+        }
+        painted.pair = pair;
+    }
 
-            if (printw("  ") == ERR) {
-                std::cerr << "Error: Failed to print spacing for row " << r << ", panel " << c << "." << std::endl;
-                return false;
-            }
+    // Repaint the previously selected word and the new one, if they differ.
+    uint32_t selection = this->find_selected_word();
+    if (painted.selection != selection) {
+        if ((painted.selection != Board::no_word) && !board.is_removed(painted.selection) && !this->render_word(painted.selection, false)) {
+            return false;
         }
-        if (printw("\n") == ERR) {
-            std::cerr << "Error: Failed to print row separator." << std::endl;
+        if ((selection != Board::no_word) && !this->render_word(selection, true)) {
             return false;
         }
+        painted.selection = selection;
     }
-    if (printw("\nPress 'q' to exit\n") == ERR) {
-        std::cerr << "Error: Failed to print exit prompt." << std::endl;
+
+    // Type the header and the new feedback lines, all at once unless animated.
+    if (!animated) {
+        typed = this->count_typed();
+    }
+    if (!this->render_typed()) {
         return false;
     }
 
-    int x_offset = getcurx(stdscr), y_offset = getcury(stdscr);
-    for (const auto &word : words) {
-        // Check if the word is selected.
-        bool is_selected = (selected_word && selected_word->string == word.string);
-
-        // Enable reverse video for selected words.
-        if (is_selected) {
-            if (attron(A_REVERSE) == ERR) {
-                std::cerr << "Error: Failed to enable reverse video attribute." << std::endl;
-                return false;
-            }
-        }
-        // Enable yellow color for unselected words.
-        else {
-            if (attron(COLOR_PAIR(1)) == ERR) {
-                std::cerr << "Error: Failed to enable yellow color for unselected word." << std::endl;
-                return false;
-            }
+    // Replace the prompt, after a bracket pair and once the round is over.
+    int prompt = (state == Won) ? 1 : ((state == Lost) ? 2 : notice);
+    if (painted.prompt != prompt) {
+        if (!this->render_prompt(prompt)) {
+            return false;
         }
+        painted.prompt = prompt;
+    }
 
-        // Print each character of the word.
-        for (std::size_t j = 0; j < word.string.length(); ++j) {
-            if (mvaddch(static_cast<int>(word.coordinates[j].y), static_cast<int>(word.coordinates[j].x), word.string[j]) == ERR) {
-                std::cerr << "Error: Failed to add character for word '" << word.string << "' at position " << j << "." << std::endl;
-                return false;
-            }
+    return true; // Indicate success.
+}
+
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+bool BasicGame<Panels, Rows, Columns>::render_scene()
+{
+    // Clear the header, it is typed by render_typed().
+    for (int i = 0; i < 2; ++i) {
+        CHECK_AND_REPORT(target.move(0, i) && target.clear_to_end_of_line(), "Failed to clear the game header.");
+    }
+
+    // Print the panels, leaving the line of the attempts to render_attempts().
+    for (std::size_t r = 0; r < layout.get_n_rows(); ++r) {
+        for (std::size_t c = 0; c < layout.get_n_panels(); ++c) {
+            // Print the preformatted address.
+            CHECK_AND_REPORT(target.move(static_cast<int>(c * panel_width(layout)), static_cast<int>(HEADER_LEN + r)) &&
+                                 target.write(addresses.data() + (r * layout.get_n_panels() + c) * (ADDRESS_LEN + 1), ADDRESS_LEN + 1, Normal),
+                             "Failed to print the address for row " << r << ", panel " << c << ".");
+
+            // Print the content, straight from the panel buffer.
+            CHECK_AND_REPORT(target.write(board.get_panel(c) + r * layout.get_n_columns(), layout.get_n_columns(), Normal),
+                             "Failed to print the panel content for row " << r << ", panel " << c << ".");
         }
+    }
+    // The feedback is printed right below the exit prompt, clear the one of
+    // the previous round.
+    painted.feedback_x = 0;
+    painted.feedback_y = static_cast<int>(HEADER_LEN + layout.get_n_rows() + 2);
+    if (!this->clear_feedback()) {
+        return false;
+    }
 
-        // Disable the color or reverse video attributes.
-        if (is_selected) {
-            if (attroff(A_REVERSE) == ERR) {
-                std::cerr << "Error: Failed to disable reverse video attribute." << std::endl;
-                return false;
-            }
-        } else {
-            if (attroff(COLOR_PAIR(1)) == ERR) {
-                std::cerr << "Error: Failed to disable yellow color for unselected word." << std::endl;
-                return false;
-            }
+    // Print all the words still on the board, none of them is selected yet.
+    for (std::size_t i = 0; i < board.get_n_words(); ++i) {
+        if (!board.is_removed(i) && !this->render_word(i, false)) {
+            return false;
         }
+    }
+    return true;
+}
 
-        if (is_selected && ((state == MousePressed) || (state == EnterPressed))) {
-            if (wmove(stdscr, y_offset + (attempts_max - attempts - 1) * 2, x_offset) == ERR) {
-                std::cerr << "Error: Failed to move the cursor for word feedback." << std::endl;
-                return false;
-            }
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+bool BasicGame<Panels, Rows, Columns>::render_attempts()
+{
+    CHECK_AND_REPORT(target.move(0, HEADER_LEN - 2), "Failed to move the cursor to the attempts.");
 
-            if (printw("> %s\n", word.string.c_str()) == ERR) {
-                std::cerr << "Error: Failed to print the selected word feedback." << std::endl;
-                return false;
-            }
+    // Remove the previous attempt markers.
+    CHECK_AND_REPORT(target.clear_to_end_of_line(), "Failed to clear the attempts line.");
 
-            if (printw("> Entry denied, %d correct.\n", common_letters) == ERR) {
-                std::cerr << "Error: Failed to print the feedback for common letters." << std::endl;
-                return false;
-            }
+    // Print attempts.
+    char buffer[32];
+    int length = std::snprintf(buffer, sizeof(buffer), "%d ATTEMPT(S) LEFT :", attempts);
+    CHECK_AND_REPORT(target.write(buffer, static_cast<std::size_t>(length), Normal), "Failed to print the remaining attempts.");
+    for (int i = 0; i < attempts; ++i) {
+        CHECK_AND_REPORT(target.write(" #", 2, Normal), "Failed to print the attempt marker.");
+    }
+    return true;
+}
+
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+bool BasicGame<Panels, Rows, Columns>::render_word(std::size_t index, bool selected)
+{
+    // Use reverse video for selected words, and yellow color for unselected ones.
+    TextAttribute attribute = selected ? Reversed : Highlighted;
+    WordView word           = board.get_word(index);
+    std::size_t panel       = board.word_panels[index];
+    std::size_t start       = board.word_starts[index];
+
+    // Print the word one row at the time, since it can wrap inside the panel.
+    for (std::size_t j = 0; j < word.length;) {
+        ScreenLocation coord = linear_to_screen_location(layout, panel, start + j);
+        std::size_t length   = std::min(word.length - j, layout.get_n_columns() - (start + j) % layout.get_n_columns());
+        CHECK_AND_REPORT(target.move(static_cast<int>(coord.x), static_cast<int>(coord.y)) &&
+                             target.write(word.data + j, length, attribute),
+                         "Failed to add characters for word '" << word.data << "' at position " << j << ".");
+        j += length;
+    }
+    return true;
+}
+
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+bool BasicGame<Panels, Rows, Columns>::render_garbage(std::size_t cell, std::size_t length, TextAttribute attribute)
+{
+    std::size_t panel = cell / (layout.get_n_rows() * layout.get_n_columns());
+    std::size_t start = cell % (layout.get_n_rows() * layout.get_n_columns());
+
+    // Print the garbage one row at the time, like the words.
+    for (std::size_t j = 0; j < length;) {
+        ScreenLocation coord = linear_to_screen_location(layout, panel, start + j);
+        std::size_t chunk    = std::min(length - j, layout.get_n_columns() - (start + j) % layout.get_n_columns());
+        CHECK_AND_REPORT(target.move(static_cast<int>(coord.x), static_cast<int>(coord.y)) &&
+                             target.write(board.get_panel(panel) + start + j, chunk, attribute),
+                         "Failed to print the garbage at position " << start + j << " of panel " << panel << ".");
+        j += chunk;
+    }
+    return true;
+}
+
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+bool BasicGame<Panels, Rows, Columns>::render_prompt(int prompt)
+{
+    CHECK_AND_REPORT(target.move(0, static_cast<int>(HEADER_LEN + layout.get_n_rows() + 1)) && target.clear_to_end_of_line() &&
+                         target.write(prompts[prompt], std::strlen(prompts[prompt]), Normal),
+                     "Failed to print the prompt.");
+    return true;
+}
+
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+bool BasicGame<Panels, Rows, Columns>::clear_feedback()
+{
+    for (int i = 0; i < 2 * attempts_max; ++i) {
+        CHECK_AND_REPORT(target.move(painted.feedback_x, painted.feedback_y + i) && target.clear_to_end_of_line(),
+                         "Failed to clear the feedback lines.");
+    }
+    return true;
+}
+
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+bool BasicGame<Panels, Rows, Columns>::render_typed()
+{
+    // Walk the lines up to the typed characters, painting the ones not shown yet.
+    char buffer[TYPED_LINE_SIZE];
+    std::size_t begin = 0, length;
+    int x, y;
+    for (std::size_t line = 0; (begin < typed) && (painted.typed < typed); ++line) {
+        const char *text = this->get_typed_line(line, buffer, length, x, y);
+        if (!text) {
+            break;
         }
+        std::size_t end = begin + length;
+        if (painted.typed < end) {
+            std::size_t from = painted.typed - begin;
+            std::size_t to   = std::min(end, typed) - begin;
+            CHECK_AND_REPORT(target.move(x + static_cast<int>(from), y) && target.write(text + from, to - from, Normal),
+                             "Failed to type line " << line << ".");
+            painted.typed = begin + to;
+        }
+        begin = end;
+    }
+    return true;
+}
+
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+const char *BasicGame<Panels, Rows, Columns>::get_typed_line(std::size_t line, char *buffer, std::size_t &length, int &x, int &y) const
+{
+    // The header comes first, straight from the constant strings.
+    if (line < 2) {
+        length = std::strlen(header[line]);
+        x      = 0;
+        y      = static_cast<int>(line);
+        return header[line];
+    }
+    // Then the guessed word and its likeness, for each wrong guess still in the log.
+    std::size_t index = scrolled + (line - 2) / 2;
+    if (index >= feedback.size()) {
+        return nullptr;
+    }
+    int written;
+    if (line % 2 == 0) {
+        WordView word = board.get_word(feedback[index].word);
+        written       = std::snprintf(buffer, TYPED_LINE_SIZE, "> %.*s", static_cast<int>(word.length), word.data);
+    } else {
+        written = std::snprintf(buffer, TYPED_LINE_SIZE, "> Entry denied, %d correct.", feedback[index].likeness);
+    }
+    length = std::min<std::size_t>(static_cast<std::size_t>(std::max(written, 0)), TYPED_LINE_SIZE - 1);
+    x      = painted.feedback_x;
+    y      = painted.feedback_y + static_cast<int>(line - 2);
+    return buffer;
+}
+
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+std::size_t BasicGame<Panels, Rows, Columns>::count_typed() const
+{
+    char buffer[TYPED_LINE_SIZE];
+    std::size_t total = 0, length;
+    int x, y;
+    for (std::size_t line = 0; this->get_typed_line(line, buffer, length, x, y); ++line) {
+        total += length;
     }
+    return total;
+}
 
-    state = Running; // Set the game state to running.
-    return true;     // Indicate success.
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+bool BasicGame<Panels, Rows, Columns>::present()
+{
+    ScreenLocation cursor = to_screen_location(layout, position);
+    return target.present(static_cast<int>(cursor.x), static_cast<int>(cursor.y));
 }
 
-void Game::parse_input(int key)
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+void BasicGame<Panels, Rows, Columns>::parse_input(const InputEvent &event)
 {
     // Check if it was a mouse click.
-    if (this->parse_mouse_position(key, position)) {
+    if (this->parse_mouse_position(event, position)) {
         state = MousePressed;
-    } else if (!this->parse_key_position(key, position)) {
-        if (key == 10) {
+    } else if (!this->parse_key_position(event.key, position)) {
+        if (event.key == 10) {
             state = EnterPressed;
+        } else if (event.key == 'h') {
+            // Move the cursor to the suggested guess.
+            std::size_t hint = solver.best_guess();
+            position         = linear_to_game_location(layout, board.word_panels[hint], board.word_starts[hint]);
         }
     }
 }
 
-bool Game::parse_mouse_position(int key, GameLocation &location) const
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+bool BasicGame<Panels, Rows, Columns>::parse_mouse_position(const InputEvent &event, GameLocation &location) const
 {
-    if (key == KEY_MOUSE) {
-        MEVENT event;
-        if (getmouse(&event) == OK) {
-            // Transform the coordinates into a screen location.
-            ScreenLocation coord{ static_cast<std::size_t>(event.x), static_cast<std::size_t>(event.y) };
-            // Transform the screen location to a game location.
-            GameLocation new_location = this->to_game_location(coord);
-            // If the new location is a valid one, save it.
-            if ((new_location.panel < n_panels) && (new_location.row < n_rows) && (new_location.column < n_columns)) {
-                location = new_location;
-                return true;
-            }
+    if ((event.key == KEY_MOUSE) && (event.x >= 0) && (event.y >= 0)) {
+        // Transform the coordinates into a screen location.
+        ScreenLocation coord{ static_cast<std::size_t>(event.x), static_cast<std::size_t>(event.y) };
+        // Transform the screen location to a game location.
+        GameLocation new_location = to_game_location(layout, coord);
+        // If the new location is a valid one, save it.
+        if ((new_location.panel < layout.get_n_panels()) && (new_location.row < layout.get_n_rows()) && (new_location.column < layout.get_n_columns())) {
+            location = new_location;
+            return true;
         }
     }
     return false;
 }
 
-bool Game::parse_key_position(int key, GameLocation &location) const
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+bool BasicGame<Panels, Rows, Columns>::parse_key_position(int key, GameLocation &location) const
 {
     if ((key == KEY_UP) && (location.row > 0)) {
         --location.row;
-    } else if ((key == KEY_DOWN) && (location.row < n_rows - 1)) {
+    } else if ((key == KEY_DOWN) && (location.row < layout.get_n_rows() - 1)) {
         ++location.row;
     } else if (key == KEY_LEFT) {
         if (location.column > 0) {
             --location.column;
         } else if (location.panel > 0) {
-            --location.column = n_columns - 1;
+            --location.column = layout.get_n_columns() - 1;
             --location.panel;
         }
     } else if (key == KEY_RIGHT) {
-        if (location.column < n_columns - 1) {
+        if (location.column < layout.get_n_columns() - 1) {
             ++location.column;
-        } else if (location.panel < n_panels - 1) {
+        } else if (location.panel < layout.get_n_panels() - 1) {
             location.column = 0;
             ++location.panel;
         }
@@ -588,159 +915,99 @@ bool Game::parse_key_position(int key, GameLocation &location) const
     return true;
 }
 
-bool Game::find_unoccupied_space_for_word(Word &word) const
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+bool BasicGame<Panels, Rows, Columns>::has_won() const
 {
-    for (std::size_t round = 0; round < 20; ++round) {
-        // Place the word.
-        word.panel = random_number<std::size_t>(0, n_panels - 1);
-        word.start = random_number<std::size_t>(0, n_rows * n_columns - word.string.length());
-        word.end   = word.start + word.string.length();
-        // Check if it overlaps with another word.
-        if (!word.overlap(words)) {
-            // Compute the coordinates from the linear location of the word,
-            // this will save us some time when we need to highlight a word.
-            for (std::size_t i = 0; i < word.string.length(); ++i) {
-                word.coordinates.emplace_back(this->linear_to_screen_location(word.panel, word.start + i));
-            }
-            return true;
-        }
-    }
-    // Reset the word data.
-    word.reset();
-    return false;
+    return state == Won;
 }
 
-std::size_t Game::compute_address(std::size_t row, std::size_t panel) const
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+bool BasicGame<Panels, Rows, Columns>::is_over() const
 {
-    return start_address + row * n_columns + panel * n_rows * n_columns;
+    return (state == Won) || (state == Lost);
 }
 
-ScreenLocation Game::to_screen_location(const GameLocation &location) const
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+const Board &BasicGame<Panels, Rows, Columns>::get_board() const
 {
-    return ScreenLocation((ADDRESS_LEN + 1) * (location.panel + 1) + (2 + n_columns) * location.panel + location.column,
-                          HEADER_LEN + location.row);
+    return board;
 }
 
-GameLocation Game::to_game_location(const ScreenLocation &location) const
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+const std::vector<typename BasicGame<Panels, Rows, Columns>::Feedback> &BasicGame<Panels, Rows, Columns>::get_feedback() const
 {
-    return GameLocation((location.x - ADDRESS_LEN - 1) / (ADDRESS_LEN + 1 + n_columns + 2),
-                        location.x % (ADDRESS_LEN + 1 + n_columns + 2) - ADDRESS_LEN - 1, location.y - HEADER_LEN);
+    return feedback;
 }
 
-GameLocation Game::linear_to_game_location(std::size_t panel, std::size_t position) const
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+const GameLocation &BasicGame<Panels, Rows, Columns>::get_position() const
 {
-    return GameLocation(panel, position % n_columns, position / n_columns);
+    return position;
 }
 
-ScreenLocation Game::linear_to_screen_location(std::size_t panel, std::size_t position) const
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+int BasicGame<Panels, Rows, Columns>::get_attempts() const
 {
-    return this->to_screen_location(this->linear_to_game_location(panel, position));
+    return attempts;
 }
 
-void Game::move_cursor_to(std::size_t panel, std::size_t column, std::size_t row) const
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+int BasicGame<Panels, Rows, Columns>::get_attempts_max() const
 {
-    this->move_cursor_to(GameLocation(panel, column, row));
+    return attempts_max;
 }
 
-void Game::move_cursor_to(const GameLocation &location) const
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+bool BasicGame<Panels, Rows, Columns>::matches(std::size_t n_panels, std::size_t n_rows, std::size_t n_columns)
 {
-    this->move_cursor_to(this->to_screen_location(location));
+    return Layout<Panels, Rows, Columns>::matches(n_panels, n_rows, n_columns);
 }
 
-void Game::move_cursor_to(const ScreenLocation &location) const
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+ScreenLocation BasicGame<Panels, Rows, Columns>::get_screen_size(std::size_t n_panels, std::size_t n_rows, std::size_t n_columns, int attempts_max)
 {
-    this->move_cursor_to(static_cast<int>(location.x), static_cast<int>(location.y));
+    // The panels side by side, unless the texts are wider, then the rows
+    // below the header, the prompt and two lines of feedback for each attempt.
+    std::size_t width = n_panels * (ADDRESS_LEN + 1 + n_columns + 2);
+    for (const char *text : header) {
+        width = std::max(width, std::strlen(text));
+    }
+    for (const char *text : prompts) {
+        width = std::max(width, std::strlen(text));
+    }
+    return ScreenLocation(width, HEADER_LEN + n_rows + 2 + 2 * static_cast<std::size_t>(attempts_max));
 }
 
-void Game::move_cursor_to(int x, int y) const
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+std::size_t BasicGame<Panels, Rows, Columns>::get_max_frame_allocations() const
 {
-    if ((y < getmaxy(stdscr)) && (x < getmaxx(stdscr))) {
-        wmove(stdscr, y, x);
-    }
+    return max_frame_allocations;
 }
 
-bool Game::load_dictionary()
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+std::size_t BasicGame<Panels, Rows, Columns>::compute_address(std::size_t row, std::size_t panel) const
 {
-    // Open the dictionary file.
-    std::ifstream file(dictionary_path);
-    if (!file.is_open()) {
-        std::cerr << "Failed to open dictionary file: " << dictionary_path << std::endl;
-        return false; // Return false if the file cannot be opened.
-    }
-
-    // Initialize the sorted dictionary with 256 groups (one for each possible length).
-    sorted_dictionary.clear();
-    sorted_dictionary.reserve(256);
-    for (std::size_t i = 0; i < 256; ++i) {
-        sorted_dictionary.emplace_back(DictionaryGroup{ i, {} });
-    }
-
-    // Clean the main dictionary.
-    dictionary.clear();
-
-    // Load the dictionary.
-    std::string word;
-
-    while (file >> word) {
-        // Validate that the word is not empty before processing.
-        if (word.empty()) {
-            std::cerr << "Encountered an empty word in the dictionary. Skipping..." << std::endl;
-            continue;
-        }
-
-        // Modify the word to uppercase.
-        std::string modified_word = string_modifier(word, toupper);
-
-        // Ensure the word fits within the expected length bounds.
-        if (modified_word.length() >= sorted_dictionary.size()) {
-            std::cerr << "Word '" << modified_word << "' exceeds the maximum supported length. Skipping..." << std::endl;
-            continue;
-        }
-
-        // Add the word to the main dictionary.
-        dictionary.emplace_back(modified_word);
-
-        // Add the word to the appropriate group in the sorted dictionary.
-        sorted_dictionary[modified_word.length()].words.push_back(modified_word);
-    }
-
-    // Save the total number of groups before the removal process.
-    std::size_t total_groups = sorted_dictionary.size();
-
-    // Count how many groups are removed during the process.
-    std::size_t removed_groups = 0;
-
-    // Remove dictionary groups with insufficient words.
-    for (auto it = sorted_dictionary.begin(); it != sorted_dictionary.end();) {
-        if (it->words.size() <= (2 * n_words)) {
-            it = sorted_dictionary.erase(it); // Erase groups with too few words.
-            removed_groups++;                 // Increment the count of removed groups.
-        } else {
-            ++it; // Move to the next group.
-        }
-    }
-
-    // Check if all groups were removed.
-    if (removed_groups == total_groups) {
-        std::cerr << "Error: All dictionary groups were removed due to n_words being too high (" << n_words << ").\n"
-                  << "Total groups before removal: " << total_groups << ", groups removed: " << removed_groups << "." << std::endl;
-        return false;
-    }
-
-    // Close the file.
-    file.close();
+    return board.start_address + address_offset(layout, row, panel);
+}
 
-    return true;
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+uint32_t BasicGame<Panels, Rows, Columns>::find_selected_word() const
+{
+    return board.word_at(position.panel, position.row * layout.get_n_columns() + position.column);
 }
 
-const Word *Game::find_selected_word() const
+template <std::size_t Panels, std::size_t Rows, std::size_t Columns>
+std::size_t BasicGame<Panels, Rows, Columns>::find_selected_pair() const
 {
-    for (const auto &word : words) {
-        if (word.is_selected(position.panel, position.row * n_columns + position.column)) {
-            return &word;
-        }
-    }
-    return nullptr;
+    std::size_t cell = position.panel * layout.get_n_rows() * layout.get_n_columns() + position.row * layout.get_n_columns() + position.column;
+    return board.pair_at(position.panel, position.row * layout.get_n_columns() + position.column) ? cell : SIZE_MAX;
 }
 
+// The coordinate math of the fixed layouts is folded at compile time.
+static_assert(to_screen_location(Layout<3, 20, 12>(3, 20, 12), GameLocation(1, 2, 3)).x == 30, "Wrong screen column.");
+static_assert(to_game_location(Layout<3, 20, 12>(3, 20, 12), ScreenLocation(30, 8)).column == 2, "Wrong game column.");
+
+template class BasicGame<0, 0, 0>;
+template class BasicGame<3, 20, 12>;
+
 } // namespace robsec
@@ -0,0 +1,129 @@
+/// @file input_log.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Implementation of the input recording and replay.
+
+#include "robsec/input_log.hpp"
+#include "robsec/varint.hpp"
+
+#include <curses.h>
+
+#include <cstring>
+#include <iostream>
+
+/// @brief Magic bytes at the beginning of a recording.
+#define RECORDING_MAGIC "ROBSREC1"
+
+/// @brief Version of the recording format.
+#define RECORDING_VERSION 2
+
+/// @brief Header of the recording file, in the native byte order.
+struct BinaryRecordingHeader {
+    char magic[8];                  ///< Must match RECORDING_MAGIC.
+    uint32_t version;               ///< Must match RECORDING_VERSION.
+    robsec::RecordingHeader header; ///< The configuration of the game.
+};
+
+namespace robsec
+{
+
+InputRecorder::InputRecorder()
+    : file(),
+      last(),
+      buffer()
+{
+    // Nothing to do.
+}
+
+bool InputRecorder::open(const std::string &path, const RecordingHeader &header)
+{
+    file.open(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: Failed to open the recording file: " << path << std::endl;
+        return false;
+    }
+    BinaryRecordingHeader binary;
+    std::memcpy(binary.magic, RECORDING_MAGIC, 8);
+    binary.version = RECORDING_VERSION;
+    binary.header  = header;
+    file.write(reinterpret_cast<const char *>(&binary), sizeof(binary));
+    last = std::chrono::steady_clock::now();
+    return static_cast<bool>(file);
+}
+
+bool InputRecorder::record(const InputEvent &event)
+{
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    buffer.clear();
+    write_varint(buffer, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(now - last).count()));
+    write_varint(buffer, zigzag_encode(event.key));
+    if (event.key == KEY_MOUSE) {
+        write_varint(buffer, zigzag_encode(event.x));
+        write_varint(buffer, zigzag_encode(event.y));
+    }
+    last = now;
+    // Flush every event, so that the recording survives a crash.
+    file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    file.flush();
+    return static_cast<bool>(file);
+}
+
+InputReplayer::InputReplayer()
+    : data(),
+      offset(0),
+      header(),
+      time(0)
+{
+    // Nothing to do.
+}
+
+bool InputReplayer::open(const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: Failed to open the recording file: " << path << std::endl;
+        return false;
+    }
+    data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+    // Check the header.
+    BinaryRecordingHeader binary;
+    if (data.size() >= sizeof(binary)) {
+        std::memcpy(&binary, data.data(), sizeof(binary));
+    }
+    if ((data.size() < sizeof(binary)) || (std::memcmp(binary.magic, RECORDING_MAGIC, 8) != 0)) {
+        std::cerr << "Error: Not a recording file: " << path << std::endl;
+        return false;
+    }
+    if (binary.version != RECORDING_VERSION) {
+        std::cerr << "Error: Unsupported recording version " << binary.version << ": " << path << std::endl;
+        return false;
+    }
+    header = binary.header;
+    offset = sizeof(binary);
+    time   = 0;
+    return true;
+}
+
+const RecordingHeader &InputReplayer::get_header() const
+{
+    return header;
+}
+
+bool InputReplayer::next(InputEvent &event, uint64_t &timestamp)
+{
+    uint64_t delta, key, x = 0, y = 0;
+    if (!read_varint(data.data(), data.size(), offset, delta) || !read_varint(data.data(), data.size(), offset, key)) {
+        return false;
+    }
+    event.key = static_cast<int>(zigzag_decode(key));
+    if ((event.key == KEY_MOUSE) && (!read_varint(data.data(), data.size(), offset, x) || !read_varint(data.data(), data.size(), offset, y))) {
+        return false;
+    }
+    event.x   = static_cast<int>(zigzag_decode(x));
+    event.y   = static_cast<int>(zigzag_decode(y));
+    time     += delta;
+    timestamp = time;
+    return true;
+}
+
+} // namespace robsec
@@ -0,0 +1,114 @@
+/// @file likeness.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Implementation of the likeness kernels.
+
+#include "robsec/likeness.hpp"
+
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#endif
+
+namespace robsec
+{
+
+int count_common_letters(const char *a, const char *b)
+{
+    int table[256] = { 0 }; // Frequency table for characters in 'a'.
+    int result     = 0;     // Counter for common characters.
+
+    // Populate the frequency table with characters from 'a'.
+    for (; *a; a++) {
+        table[static_cast<unsigned char>(*a)]++;
+    }
+
+    // Count matching characters from 'b' in the frequency table.
+    for (; *b; b++) {
+        result += (table[static_cast<unsigned char>(*b)]-- > 0);
+    }
+
+    return result; // Return the count of common letters.
+}
+
+LetterHistogram::LetterHistogram(const char *word, std::size_t length)
+    : counts(),
+      letters_only(true)
+{
+    for (std::size_t i = 0; i < length; ++i) {
+        if ((word[i] >= 'A') && (word[i] <= 'Z')) {
+            ++counts[word[i] - 'A' + 1];
+        } else {
+            letters_only = false;
+        }
+    }
+}
+
+int count_common_letters(const LetterHistogram &a, const LetterHistogram &b)
+{
+#if defined(__SSE2__)
+    // Lane-wise minimum, then the horizontal sum of the bytes.
+    __m128i lo  = _mm_min_epu8(_mm_load_si128(reinterpret_cast<const __m128i *>(a.counts)),
+                               _mm_load_si128(reinterpret_cast<const __m128i *>(b.counts)));
+    __m128i hi  = _mm_min_epu8(_mm_load_si128(reinterpret_cast<const __m128i *>(a.counts + 16)),
+                               _mm_load_si128(reinterpret_cast<const __m128i *>(b.counts + 16)));
+    __m128i sum = _mm_add_epi64(_mm_sad_epu8(lo, _mm_setzero_si128()), _mm_sad_epu8(hi, _mm_setzero_si128()));
+    return _mm_cvtsi128_si32(sum) + _mm_cvtsi128_si32(_mm_unpackhi_epi64(sum, sum));
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    // Lane-wise minimum, then the horizontal sum of the bytes.
+    uint8x16_t lo = vminq_u8(vld1q_u8(a.counts), vld1q_u8(b.counts));
+    uint8x16_t hi = vminq_u8(vld1q_u8(a.counts + 16), vld1q_u8(b.counts + 16));
+    return static_cast<int>(vaddlvq_u8(lo)) + static_cast<int>(vaddlvq_u8(hi));
+#else
+    int result = 0;
+    for (std::size_t i = 0; i < 32; ++i) {
+        result += (a.counts[i] < b.counts[i]) ? a.counts[i] : b.counts[i];
+    }
+    return result;
+#endif
+}
+
+LikenessMatrix::LikenessMatrix()
+    : size(0),
+      values(),
+      histograms()
+{
+    // Nothing to do.
+}
+
+void LikenessMatrix::build(const DictionaryGroup &group, const uint32_t *ids, std::size_t n_ids)
+{
+    size = n_ids;
+    values.assign(size * size, 0);
+
+    // Compute the histograms once.
+    histograms.clear();
+    histograms.reserve(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        histograms.emplace_back(group[ids[i]].data, group.length);
+    }
+
+    // The likeness is symmetric, so compute only half of the matrix.
+    for (std::size_t i = 0; i < size; ++i) {
+        for (std::size_t j = i; j < size; ++j) {
+            int likeness;
+            if (histograms[i].letters_only && histograms[j].letters_only) {
+                likeness = count_common_letters(histograms[i], histograms[j]);
+            } else {
+                likeness = count_common_letters(group[ids[i]].data, group[ids[j]].data);
+            }
+            values[i * size + j] = values[j * size + i] = static_cast<uint8_t>(likeness);
+        }
+    }
+}
+
+void LikenessMatrix::clear()
+{
+    size = 0;
+    values.clear();
+    histograms.clear();
+}
+
+} // namespace robsec
@@ -0,0 +1,173 @@
+/// @file likeness_index.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Implementation of the likeness index.
+
+#include "robsec/likeness_index.hpp"
+#include "robsec/likeness.hpp"
+
+#include <algorithm>
+
+/// @brief Largest group whose words are all compared with each other.
+#define EXHAUSTIVE_LIMIT 2048
+
+/// @brief Number of bands of the locality-sensitive hashing.
+#define LSH_BANDS 8
+
+/// @brief Number of MinHash values combined in each band.
+#define LSH_ROWS 2
+
+/// @brief Number of following words of the same bucket each word is compared with.
+#define LSH_WINDOW 32
+
+/// @brief Mixes the bits of the value, with the finalizer of SplitMix64.
+///
+/// @param x The value to mix.
+/// @return The mixed value.
+static inline uint64_t mix(uint64_t x)
+{
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+/// @brief Computes the MinHash of the letter multiset of a word.
+/// @details Each occurrence of a letter is a distinct element, so that the
+/// similarity of the multisets follows the number of common letters.
+///
+/// @param histogram The histogram of the word.
+/// @param function The index of the hash function.
+/// @return The minimum hash among the elements.
+static inline uint64_t min_hash(const robsec::LetterHistogram &histogram, uint64_t function)
+{
+    uint64_t minimum = UINT64_MAX;
+    for (uint64_t letter = 0; letter < 32; ++letter) {
+        for (uint64_t occurrence = 0; occurrence < histogram.counts[letter]; ++occurrence) {
+            minimum = std::min(minimum, mix((letter << 8 | occurrence) + function * 0x9E3779B97F4A7C15ULL));
+        }
+    }
+    return minimum;
+}
+
+/// @brief Offers a candidate neighbor to a word, keeping its neighbors sorted
+/// by decreasing likeness.
+///
+/// @param ids The neighbors of the word.
+/// @param likeness The likeness of the neighbors of the word.
+/// @param n_neighbors The number of neighbors of the word.
+/// @param candidate The candidate neighbor.
+/// @param value The likeness of the candidate.
+static inline void offer(uint32_t *ids, uint8_t *likeness, std::size_t n_neighbors, uint32_t candidate, uint8_t value)
+{
+    // Ignore the candidates which are not better than the last neighbor, or already present.
+    if ((ids[n_neighbors - 1] != robsec::LikenessIndex::no_neighbor) && (likeness[n_neighbors - 1] >= value)) {
+        return;
+    }
+    std::size_t position = n_neighbors - 1;
+    for (std::size_t i = 0; i < n_neighbors; ++i) {
+        if (ids[i] == candidate) {
+            return;
+        }
+        if ((ids[i] == robsec::LikenessIndex::no_neighbor) || (likeness[i] < value)) {
+            position = i;
+            break;
+        }
+    }
+    // Shift the worse neighbors, dropping the last one.
+    for (std::size_t i = n_neighbors - 1; i > position; --i) {
+        ids[i]      = ids[i - 1];
+        likeness[i] = likeness[i - 1];
+    }
+    ids[position]      = candidate;
+    likeness[position] = value;
+}
+
+namespace robsec
+{
+
+const uint32_t LikenessIndex::no_neighbor = UINT32_MAX;
+
+const std::size_t LikenessIndex::neighbors_per_board_word = 4;
+
+LikenessIndex::LikenessIndex()
+    : n_neighbors(0),
+      groups()
+{
+    // Nothing to do.
+}
+
+void LikenessIndex::build(const Dictionary &dictionary, std::size_t _n_neighbors)
+{
+    n_neighbors = std::max<std::size_t>(1, _n_neighbors);
+    groups.assign(dictionary.get_groups().size(), std::vector<uint32_t>());
+    for (std::size_t i = 0; i < groups.size(); ++i) {
+        this->build_group(dictionary.get_groups()[i], groups[i]);
+    }
+}
+
+std::size_t LikenessIndex::get_n_neighbors() const
+{
+    return n_neighbors;
+}
+
+void LikenessIndex::build_group(const DictionaryGroup &group, std::vector<uint32_t> &neighbors) const
+{
+    const std::size_t n = group.size();
+    neighbors.assign(n * n_neighbors, no_neighbor);
+    std::vector<uint8_t> likeness(n * n_neighbors, 0);
+
+    // Compute the histograms once.
+    std::vector<LetterHistogram> histograms;
+    histograms.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        histograms.emplace_back(group[i].data, group.length);
+    }
+
+    // Compares two words, and offers each one to the other.
+    auto compare = [&](std::size_t i, std::size_t j) {
+        int value;
+        if (histograms[i].letters_only && histograms[j].letters_only) {
+            value = count_common_letters(histograms[i], histograms[j]);
+        } else {
+            value = count_common_letters(group[i].data, group[j].data);
+        }
+        offer(&neighbors[i * n_neighbors], &likeness[i * n_neighbors], n_neighbors, static_cast<uint32_t>(j), static_cast<uint8_t>(value));
+        offer(&neighbors[j * n_neighbors], &likeness[j * n_neighbors], n_neighbors, static_cast<uint32_t>(i), static_cast<uint8_t>(value));
+    };
+
+    // Compare all the pairs of a small group.
+    if (n <= EXHAUSTIVE_LIMIT) {
+        for (std::size_t i = 0; i < n; ++i) {
+            for (std::size_t j = i + 1; j < n; ++j) {
+                compare(i, j);
+            }
+        }
+        return;
+    }
+
+    // Compare the words sharing a bucket in some band. The buckets are sorted
+    // runs of words, and each word is compared with the ones following it in
+    // its run, up to a window, so that crowded buckets stay linear.
+    std::vector<std::pair<uint64_t, uint32_t>> buckets;
+    buckets.reserve(n);
+    for (uint64_t band = 0; band < LSH_BANDS; ++band) {
+        buckets.clear();
+        for (std::size_t i = 0; i < n; ++i) {
+            if (!histograms[i].letters_only) {
+                continue;
+            }
+            uint64_t key = 0;
+            for (uint64_t row = 0; row < LSH_ROWS; ++row) {
+                key = mix(key ^ min_hash(histograms[i], band * LSH_ROWS + row));
+            }
+            buckets.emplace_back(key, static_cast<uint32_t>(i));
+        }
+        std::sort(buckets.begin(), buckets.end());
+        for (std::size_t i = 0; i < buckets.size(); ++i) {
+            for (std::size_t j = i + 1; (j < buckets.size()) && (j <= i + LSH_WINDOW) && (buckets[j].first == buckets[i].first); ++j) {
+                compare(buckets[i].second, buckets[j].second);
+            }
+        }
+    }
+}
+
+} // namespace robsec
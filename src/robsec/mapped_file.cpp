@@ -0,0 +1,97 @@
+/// @file mapped_file.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Implementation of the read-only memory mapping.
+
+#include "robsec/mapped_file.hpp"
+
+#if defined(_WIN32)
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace robsec
+{
+
+MappedFile::MappedFile()
+    : data(nullptr),
+      size(0),
+      buffer()
+{
+    // Nothing to do.
+}
+
+MappedFile::~MappedFile()
+{
+    this->close();
+}
+
+bool MappedFile::open(const std::string &path)
+{
+    this->close();
+#if defined(_WIN32)
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return false;
+    }
+    buffer.resize(static_cast<std::size_t>(file.tellg()));
+    file.seekg(0);
+    if (!file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()))) {
+        buffer.clear();
+        return false;
+    }
+    data = buffer.data();
+    size = buffer.size();
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) < 0) {
+        ::close(fd);
+        return false;
+    }
+    size = static_cast<std::size_t>(info.st_size);
+    // An empty file cannot be mapped, but it is still a valid file.
+    if (size > 0) {
+        void *address = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address == MAP_FAILED) {
+            ::close(fd);
+            size = 0;
+            return false;
+        }
+        data = static_cast<const char *>(address);
+    }
+    // The mapping stays valid after the descriptor is closed.
+    ::close(fd);
+#endif
+    return true;
+}
+
+void MappedFile::close()
+{
+#if !defined(_WIN32)
+    if (data && size) {
+        ::munmap(const_cast<char *>(data), size);
+    }
+#endif
+    buffer.clear();
+    data = nullptr;
+    size = 0;
+}
+
+const char *MappedFile::get_data() const
+{
+    return data;
+}
+
+std::size_t MappedFile::get_size() const
+{
+    return size;
+}
+
+} // namespace robsec
@@ -0,0 +1,335 @@
+/// @file render_target.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Implementation of the render targets.
+
+#include "robsec/render_target.hpp"
+
+#include <curses.h>
+
+#include <cstdio>
+#include <iostream>
+
+namespace robsec
+{
+
+RenderTarget::~RenderTarget()
+{
+    // Nothing to do.
+}
+
+CursesRenderTarget::CursesRenderTarget()
+{
+    // Nothing to do.
+}
+
+bool CursesRenderTarget::start()
+{
+    // Initialize NCurses.
+    if (initscr() == nullptr) {
+        std::cerr << "Error: Failed to initialize NCurses." << std::endl;
+        return false;
+    }
+
+    // Clear the screen.
+    if (clear() == ERR) {
+        std::cerr << "Error: Failed to clear the screen in NCurses." << std::endl;
+        endwin();
+        return false;
+    }
+
+    // Disable echo.
+    if (noecho() == ERR) {
+        std::cerr << "Error: Failed to disable echo in NCurses." << std::endl;
+        endwin();
+        return false;
+    }
+
+    // Enable cbreak mode.
+    if (cbreak() == ERR) {
+        std::cerr << "Error: Failed to enable cbreak mode in NCurses." << std::endl;
+        endwin();
+        return false;
+    }
+
+    // Enable keypad input for the main window.
+    if (keypad(stdscr, true) == ERR) {
+        std::cerr << "Error: Failed to enable keypad input in NCurses." << std::endl;
+        endwin();
+        return false;
+    }
+
+    // Initialize colors in NCurses.
+    if (start_color() == ERR) {
+        std::cerr << "Error: Failed to initialize colors in NCurses." << std::endl;
+        endwin();
+        return false;
+    }
+
+    // Enable support for default background color.
+    if (use_default_colors() == ERR) {
+        std::cerr << "Error: Failed to enable default terminal background color." << std::endl;
+        endwin();
+        return false;
+    }
+
+    // Define a color pair for yellow text with a transparent (default) background.
+    if (init_pair(1, COLOR_YELLOW, -1) == ERR) {
+        std::cerr << "Error: Failed to define color pair 1 (yellow on default background)." << std::endl;
+        endwin();
+        return false;
+    }
+    return true;
+}
+
+void CursesRenderTarget::stop()
+{
+    endwin();
+}
+
+int CursesRenderTarget::get_width() const
+{
+    return getmaxx(stdscr);
+}
+
+int CursesRenderTarget::get_height() const
+{
+    return getmaxy(stdscr);
+}
+
+bool CursesRenderTarget::move(int x, int y)
+{
+    return wmove(stdscr, y, x) != ERR;
+}
+
+bool CursesRenderTarget::write(const char *text, std::size_t length, TextAttribute attribute)
+{
+    // Enable reverse video for selected words, and yellow color for the others.
+    int attributes = 0;
+    if (attribute == Highlighted) {
+        attributes = static_cast<int>(COLOR_PAIR(1));
+    } else if (attribute == Reversed) {
+        attributes = A_REVERSE;
+    }
+    if (attributes && (attron(attributes) == ERR)) {
+        return false;
+    }
+    // Curses fails when it writes the bottom-right cell, which is not an issue.
+    bool success = addnstr(text, static_cast<int>(length)) != ERR;
+    if (attributes && (attroff(attributes) == ERR)) {
+        return false;
+    }
+    return success;
+}
+
+bool CursesRenderTarget::clear_to_end_of_line()
+{
+    return clrtoeol() != ERR;
+}
+
+bool CursesRenderTarget::present(int cursor_x, int cursor_y)
+{
+    // Leave the cursor where it is, if the position is outside the window.
+    if ((cursor_y < getmaxy(stdscr)) && (cursor_x < getmaxx(stdscr))) {
+        wmove(stdscr, cursor_y, cursor_x);
+    }
+    return refresh() != ERR;
+}
+
+FrameBufferRenderTarget::FrameBufferRenderTarget(int _width, int _height)
+    : width(_width),
+      height(_height),
+      x(0),
+      y(0),
+      back(static_cast<std::size_t>(width * height), Cell{ ' ', Normal }),
+      front(back),
+      output(),
+      cleared(false)
+{
+    // Nothing to do.
+}
+
+bool FrameBufferRenderTarget::start()
+{
+    // Start from a blank grid, and clear the terminal on the next present.
+    back.assign(back.size(), Cell{ ' ', Normal });
+    front   = back;
+    x       = 0;
+    y       = 0;
+    cleared = false;
+    return true;
+}
+
+void FrameBufferRenderTarget::stop()
+{
+    // Restore the default attributes.
+    output.append("\x1b[0m");
+}
+
+int FrameBufferRenderTarget::get_width() const
+{
+    return width;
+}
+
+int FrameBufferRenderTarget::get_height() const
+{
+    return height;
+}
+
+bool FrameBufferRenderTarget::move(int _x, int _y)
+{
+    if ((_x < 0) || (_x >= width) || (_y < 0) || (_y >= height)) {
+        return false;
+    }
+    x = _x;
+    y = _y;
+    return true;
+}
+
+bool FrameBufferRenderTarget::write(const char *text, std::size_t length, TextAttribute attribute)
+{
+    // The text must fit in the current row.
+    if (static_cast<std::size_t>(width - x) < length) {
+        return false;
+    }
+    Cell *cell = &back[static_cast<std::size_t>(y * width + x)];
+    for (std::size_t i = 0; i < length; ++i) {
+        cell[i].character = text[i];
+        cell[i].attribute = static_cast<uint8_t>(attribute);
+    }
+    x += static_cast<int>(length);
+    return true;
+}
+
+bool FrameBufferRenderTarget::clear_to_end_of_line()
+{
+    for (int i = x; i < width; ++i) {
+        back[static_cast<std::size_t>(y * width + i)] = Cell{ ' ', Normal };
+    }
+    return true;
+}
+
+bool FrameBufferRenderTarget::present(int cursor_x, int cursor_y)
+{
+    // The escape sequences selecting each attribute.
+    static const char *const sequences[] = { "\x1b[0m", "\x1b[0;33m", "\x1b[0;7m" };
+    char buffer[32];
+
+    // Clear the terminal the first time, the front grid starts blank.
+    if (!cleared) {
+        output.append("\x1b[0m\x1b[2J");
+        cleared = true;
+    }
+
+    // Emit only the cells that changed, moving the cursor only when they are
+    // not contiguous and switching attribute only when it is different.
+    int attribute = -1;
+    int next      = -1;
+    for (int i = 0; i < width * height; ++i) {
+        const Cell &cell = back[static_cast<std::size_t>(i)];
+        if (cell == front[static_cast<std::size_t>(i)]) {
+            continue;
+        }
+        if ((next != -1) && (next != i) && (i - next <= 4) && (next / width == i / width)) {
+            // Rewriting a few unchanged cells is shorter than moving the
+            // cursor, as long as they share the current attribute.
+            int j = next;
+            while ((j < i) && (back[static_cast<std::size_t>(j)].attribute == attribute)) {
+                ++j;
+            }
+            if (j == i) {
+                for (j = next; j < i; ++j) {
+                    output.push_back(back[static_cast<std::size_t>(j)].character);
+                }
+                next = i;
+            }
+        }
+        if (next != i) {
+            std::snprintf(buffer, sizeof(buffer), "\x1b[%d;%dH", i / width + 1, i % width + 1);
+            output.append(buffer);
+        }
+        if (attribute != cell.attribute) {
+            output.append(sequences[cell.attribute]);
+            attribute = cell.attribute;
+        }
+        output.push_back(cell.character);
+        front[static_cast<std::size_t>(i)] = cell;
+        // Do not rely on the terminal wrapping after the last column.
+        next = ((i + 1) % width) ? (i + 1) : -1;
+    }
+
+    // Place the cursor.
+    if ((cursor_x >= 0) && (cursor_x < width) && (cursor_y >= 0) && (cursor_y < height)) {
+        std::snprintf(buffer, sizeof(buffer), "\x1b[%d;%dH", cursor_y + 1, cursor_x + 1);
+        output.append(buffer);
+    }
+    return true;
+}
+
+char FrameBufferRenderTarget::get_character(int _x, int _y) const
+{
+    return front[static_cast<std::size_t>(_y * width + _x)].character;
+}
+
+const std::string &FrameBufferRenderTarget::get_output() const
+{
+    return output;
+}
+
+void FrameBufferRenderTarget::append_output(const char *text)
+{
+    output.append(text);
+}
+
+void FrameBufferRenderTarget::clear_output()
+{
+    output.clear();
+}
+
+NullRenderTarget::NullRenderTarget(int _width, int _height)
+    : width(_width),
+      height(_height)
+{
+    // Nothing to do.
+}
+
+bool NullRenderTarget::start()
+{
+    return true;
+}
+
+void NullRenderTarget::stop()
+{
+    // Nothing to do.
+}
+
+int NullRenderTarget::get_width() const
+{
+    return width;
+}
+
+int NullRenderTarget::get_height() const
+{
+    return height;
+}
+
+bool NullRenderTarget::move(int _x, int _y)
+{
+    return (_x >= 0) && (_x < width) && (_y >= 0) && (_y < height);
+}
+
+bool NullRenderTarget::write(const char *, std::size_t, TextAttribute)
+{
+    return true;
+}
+
+bool NullRenderTarget::clear_to_end_of_line()
+{
+    return true;
+}
+
+bool NullRenderTarget::present(int, int)
+{
+    return true;
+}
+
+} // namespace robsec
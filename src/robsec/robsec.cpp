@@ -0,0 +1,216 @@
+/// @file robsec.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Implementation of the C interface of the game.
+
+#include "robsec/robsec.h"
+#include "robsec/dictionary_cache.hpp"
+#include "robsec/game.hpp"
+#include "robsec/render_target.hpp"
+
+#include <curses.h>
+
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <iostream>
+
+// The feedback of the game is handed out as it is.
+static_assert(sizeof(robsec_feedback) == sizeof(robsec::Game::Feedback), "The feedback layouts differ.");
+static_assert(offsetof(robsec_feedback, word) == offsetof(robsec::Game::Feedback, word), "The feedback layouts differ.");
+static_assert(offsetof(robsec_feedback, likeness) == offsetof(robsec::Game::Feedback, likeness), "The feedback layouts differ.");
+
+/// @brief A dictionary shared with the games created from it.
+struct robsec_dictionary {
+    std::shared_ptr<const robsec::Dictionary> dictionary; ///< The shared dictionary.
+};
+
+/// @brief A game, rendering to nothing since the host draws the board itself.
+struct robsec_game {
+    robsec::NullRenderTarget target; ///< The target of the game, which discards everything.
+    robsec::Game game;               ///< The game.
+    std::vector<char> snapshot;      ///< The last snapshot of the game.
+
+    /// @brief Constructs the game.
+    robsec_game(const std::shared_ptr<const robsec::Dictionary> &dictionary, const robsec_config &config, const robsec::ScreenLocation &size)
+        : target(static_cast<int>(size.x), static_cast<int>(size.y)),
+          game(target, dictionary, config.n_panels, config.n_rows, config.n_columns, config.n_words, config.attempts_max, config.seed, nullptr),
+          snapshot()
+    {
+        // Nothing to do.
+    }
+};
+
+/// @brief Converts a key of the interface to the one of the game.
+///
+/// @param key The key of the interface.
+/// @return The key of the game.
+static inline int to_game_key(int key)
+{
+    switch (key) {
+    case ROBSEC_KEY_UP:
+        return KEY_UP;
+    case ROBSEC_KEY_DOWN:
+        return KEY_DOWN;
+    case ROBSEC_KEY_LEFT:
+        return KEY_LEFT;
+    case ROBSEC_KEY_RIGHT:
+        return KEY_RIGHT;
+    default:
+        return key;
+    }
+}
+
+extern "C" {
+
+robsec_dictionary *robsec_dictionary_acquire(const char *paths, int deduplicate)
+{
+    if (paths == nullptr) {
+        std::cerr << "Error: No dictionary given." << std::endl;
+        return nullptr;
+    }
+    try {
+        std::shared_ptr<const robsec::Dictionary> dictionary = robsec::DictionaryCache::acquire(paths, deduplicate != 0);
+        if (!dictionary) {
+            return nullptr;
+        }
+        return new robsec_dictionary{ dictionary };
+    } catch (const std::exception &e) {
+        std::cerr << "Error: Failed to acquire the dictionary. Exception: " << e.what() << std::endl;
+        return nullptr;
+    }
+}
+
+void robsec_dictionary_release(robsec_dictionary *dictionary)
+{
+    delete dictionary;
+}
+
+robsec_game *robsec_game_create(const robsec_dictionary *dictionary, const robsec_config *config)
+{
+    if ((dictionary == nullptr) || (config == nullptr)) {
+        std::cerr << "Error: A game needs a dictionary and a configuration." << std::endl;
+        return nullptr;
+    }
+    if ((config->n_panels == 0) || (config->n_rows == 0) || (config->n_columns == 0) || (config->n_words == 0) || (config->attempts_max <= 0)) {
+        std::cerr << "Error: The layout, the words and the attempts must be positive." << std::endl;
+        return nullptr;
+    }
+    try {
+        robsec::ScreenLocation size = robsec::Game::get_screen_size(config->n_panels, config->n_rows, config->n_columns, config->attempts_max);
+        robsec_game *game           = new robsec_game(dictionary->dictionary, *config, size);
+        if (!game->game.initialize()) {
+            delete game;
+            return nullptr;
+        }
+        return game;
+    } catch (const std::exception &e) {
+        std::cerr << "Error: Failed to create the game. Exception: " << e.what() << std::endl;
+        return nullptr;
+    }
+}
+
+void robsec_game_destroy(robsec_game *game)
+{
+    delete game;
+}
+
+int robsec_game_key(robsec_game *game, int key)
+{
+    if (game == nullptr) {
+        std::cerr << "Error: No game given." << std::endl;
+        return 0;
+    }
+    return game->game.handle_key(to_game_key(key)) ? 1 : 0;
+}
+
+int robsec_game_click(robsec_game *game, size_t panel, size_t row, size_t column)
+{
+    if (game == nullptr) {
+        std::cerr << "Error: No game given." << std::endl;
+        return 0;
+    }
+    const robsec::Board &board = game->game.get_board();
+    if ((panel >= board.n_panels) || (row >= board.n_rows) || (column >= board.n_columns)) {
+        std::cerr << "Error: The cell (" << panel << ", " << row << ", " << column << ") is outside of the board." << std::endl;
+        return 0;
+    }
+    robsec::ScreenLocation cell = robsec::to_screen_location(robsec::Layout<0, 0, 0>(board.n_panels, board.n_rows, board.n_columns), robsec::GameLocation(panel, column, row));
+    robsec::InputEvent event{ KEY_MOUSE, static_cast<int>(cell.x), static_cast<int>(cell.y) };
+    return game->game.handle_input(&event, 1) ? 1 : 0;
+}
+
+int robsec_game_new_round(robsec_game *game)
+{
+    if (game == nullptr) {
+        std::cerr << "Error: No game given." << std::endl;
+        return 0;
+    }
+    return game->game.new_round() ? 1 : 0;
+}
+
+size_t robsec_game_save(robsec_game *game, char *buffer, size_t size)
+{
+    if (game == nullptr) {
+        std::cerr << "Error: No game given." << std::endl;
+        return 0;
+    }
+    game->snapshot.clear();
+    if (!game->game.serialize(game->snapshot)) {
+        return 0;
+    }
+    if ((buffer != nullptr) && (game->snapshot.size() <= size)) {
+        std::memcpy(buffer, game->snapshot.data(), game->snapshot.size());
+    }
+    return game->snapshot.size();
+}
+
+int robsec_game_load(robsec_game *game, const char *data, size_t size)
+{
+    if ((game == nullptr) || (data == nullptr)) {
+        std::cerr << "Error: Loading a snapshot needs a game and the snapshot." << std::endl;
+        return 0;
+    }
+    try {
+        return game->game.deserialize(data, size) ? 1 : 0;
+    } catch (const std::exception &e) {
+        std::cerr << "Error: Failed to load the snapshot. Exception: " << e.what() << std::endl;
+        return 0;
+    }
+}
+
+void robsec_game_view(const robsec_game *game, robsec_board_view *view)
+{
+    if ((game == nullptr) || (view == nullptr)) {
+        std::cerr << "Error: A view needs a game and the view to fill." << std::endl;
+        return;
+    }
+    const robsec::Board &board                          = game->game.get_board();
+    const robsec::GameLocation &position                = game->game.get_position();
+    const std::vector<robsec::Game::Feedback> &feedback = game->game.get_feedback();
+
+    view->n_panels      = board.n_panels;
+    view->n_rows        = board.n_rows;
+    view->n_columns     = board.n_columns;
+    view->content       = board.get_panel(0);
+    view->cells         = board.cells.data();
+    view->pairs         = board.pairs.data();
+    view->start_address = board.start_address;
+    view->n_words       = board.get_n_words();
+    view->word_length   = board.get_word_length();
+    view->words         = board.group ? board.group->data : nullptr;
+    view->word_ids      = board.word_ids.data();
+    view->word_panels   = board.word_panels.data();
+    view->word_starts   = board.word_starts.data();
+    view->likeness      = board.likeness.row(0);
+    view->feedback      = reinterpret_cast<const robsec_feedback *>(feedback.data());
+    view->n_feedback    = feedback.size();
+    view->cursor_panel  = position.panel;
+    view->cursor_row    = position.row;
+    view->cursor_column = position.column;
+    view->selected_word = game->game.find_selected_word();
+    view->attempts      = game->game.get_attempts();
+    view->attempts_max  = game->game.get_attempts_max();
+    view->state         = game->game.has_won() ? ROBSEC_WON : (game->game.is_over() ? ROBSEC_LOST : ROBSEC_RUNNING);
+}
+
+} // extern "C"
@@ -0,0 +1,544 @@
+/// @file server.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Implementation of the telnet server.
+
+#include "robsec/server.hpp"
+
+#include <curses.h>
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#endif
+
+/// @brief Telnet: interpret as command.
+#define TELNET_IAC 255
+/// @brief Telnet: start of a subnegotiation.
+#define TELNET_SB 250
+/// @brief Telnet: end of a subnegotiation.
+#define TELNET_SE 240
+/// @brief Telnet: first of the option negotiation commands (WILL, WONT, DO, DONT).
+#define TELNET_WILL 251
+
+/// @brief Asks the client to let the server echo and to send characters
+/// without waiting for a full line (WILL ECHO, WILL SUPPRESS-GO-AHEAD).
+static const char telnet_negotiation[] = { '\xff', '\xfb', '\x01', '\xff', '\xfb', '\x03' };
+
+/// @brief Set when the process is interrupted.
+static volatile std::sig_atomic_t interrupted = 0;
+
+/// @brief Stops the event loop.
+static void handle_interrupt(int)
+{
+    interrupted = 1;
+}
+
+namespace robsec
+{
+
+/// @brief States of the telnet command parser.
+enum TelnetState {
+    TelnetData,              ///< Plain data.
+    TelnetCommand,           ///< After IAC.
+    TelnetOption,            ///< After IAC WILL/WONT/DO/DONT.
+    TelnetSubnegotiation,    ///< Inside IAC SB.
+    TelnetSubnegotiationIac, ///< After IAC, inside IAC SB.
+};
+
+/// @brief States of the ANSI escape sequence parser.
+enum EscapeState {
+    EscapeNone,     ///< Outside of a sequence.
+    EscapeStart,    ///< After ESC.
+    EscapeSequence, ///< After ESC [ or ESC O.
+};
+
+Server::Session::Session(int _fd,
+                         const ScreenLocation &size,
+                         const std::shared_ptr<const Dictionary> &dictionary,
+                         std::size_t n_panels,
+                         std::size_t n_rows,
+                         std::size_t n_columns,
+                         std::size_t n_words,
+                         int attempts_max,
+                         unsigned seed,
+                         BoardPrefetcher *prefetcher)
+    : fd(_fd),
+      target(static_cast<int>(size.x), static_cast<int>(size.y)),
+      game(target, dictionary, n_panels, n_rows, n_columns, n_words, attempts_max, seed, prefetcher),
+      sent(0),
+      closing(false),
+      writable(false),
+      telnet(TelnetData),
+      escape(EscapeNone),
+      carriage_return(false)
+{
+    // Nothing to do.
+}
+
+Server::Server(std::shared_ptr<const Dictionary> _dictionary,
+               std::size_t _n_panels,
+               std::size_t _n_rows,
+               std::size_t _n_columns,
+               std::size_t _n_words,
+               int _attempts_max,
+               unsigned _seed,
+               BoardPrefetcher *_prefetcher)
+    : dictionary(_dictionary),
+      n_panels(_n_panels),
+      n_rows(_n_rows),
+      n_columns(_n_columns),
+      n_words(_n_words),
+      attempts_max(_attempts_max),
+      seed(_seed),
+      prefetcher(_prefetcher),
+      index(nullptr),
+      difficulty(Unrated),
+      animated(false),
+      n_sessions(0),
+      listener(-1),
+      poller(-1),
+      ticker(-1),
+      sessions(),
+      animating()
+{
+    // Nothing to do.
+}
+
+void Server::set_difficulty(const LikenessIndex *_index, Difficulty _difficulty)
+{
+    index      = _index;
+    difficulty = _difficulty;
+}
+
+void Server::set_animated(bool _animated)
+{
+    animated = _animated;
+}
+
+#ifdef __linux__
+
+/// @brief Arms or disarms a periodic timer.
+///
+/// @param timer The timer.
+/// @param armed If true, the timer expires every ANIMATION_TICK_MS from now, otherwise it stops.
+static inline void arm_timer(int timer, bool armed)
+{
+    itimerspec spec;
+    std::memset(&spec, 0, sizeof(spec));
+    if (armed) {
+        spec.it_interval.tv_nsec = ANIMATION_TICK_MS * 1000000L;
+        spec.it_value            = spec.it_interval;
+    }
+    timerfd_settime(timer, 0, &spec, nullptr);
+}
+
+Server::~Server()
+{
+    while (!sessions.empty()) {
+        this->close(sessions.begin()->first);
+    }
+    if (ticker != -1) {
+        ::close(ticker);
+    }
+    if (poller != -1) {
+        ::close(poller);
+    }
+    if (listener != -1) {
+        ::close(listener);
+    }
+}
+
+bool Server::serve(uint16_t port)
+{
+    // Create the listening socket.
+    listener = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listener == -1) {
+        std::cerr << "Error: Failed to create the socket: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    int reuse = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family      = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port        = htons(port);
+    if (bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == -1) {
+        std::cerr << "Error: Failed to bind port " << port << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    if (listen(listener, SOMAXCONN) == -1) {
+        std::cerr << "Error: Failed to listen on port " << port << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    // Create the event loop, starting from the listening socket.
+    poller = epoll_create1(EPOLL_CLOEXEC);
+    if (poller == -1) {
+        std::cerr << "Error: Failed to create the event loop: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    epoll_event event;
+    event.events  = EPOLLIN;
+    event.data.fd = listener;
+    if (epoll_ctl(poller, EPOLL_CTL_ADD, listener, &event) == -1) {
+        std::cerr << "Error: Failed to poll the socket: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    // Create the timer of the animations, disarmed until a game animates.
+    ticker = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (ticker == -1) {
+        std::cerr << "Error: Failed to create the timer: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    event.events  = EPOLLIN;
+    event.data.fd = ticker;
+    if (epoll_ctl(poller, EPOLL_CTL_ADD, ticker, &event) == -1) {
+        std::cerr << "Error: Failed to poll the timer: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    // Stop on interrupt, and do not die when a client disconnects.
+    std::signal(SIGINT, handle_interrupt);
+    std::signal(SIGTERM, handle_interrupt);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    std::cerr << "Serving on port " << port << "." << std::endl;
+
+    epoll_event events[64];
+    while (!interrupted) {
+        int count = epoll_wait(poller, events, 64, -1);
+        if (count == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "Error: Failed to wait for events: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        for (int i = 0; i < count; ++i) {
+            if (events[i].data.fd == listener) {
+                this->accept_clients();
+                continue;
+            }
+            if (events[i].data.fd == ticker) {
+                this->tick();
+                continue;
+            }
+            // The session may have been closed by a previous event.
+            auto it = sessions.find(events[i].data.fd);
+            if (it == sessions.end()) {
+                continue;
+            }
+            Session &session = *it->second;
+            if (events[i].events & (EPOLLHUP | EPOLLERR)) {
+                this->close(session.fd);
+            } else if (events[i].events & EPOLLIN) {
+                this->receive(session);
+            } else if (events[i].events & EPOLLOUT) {
+                this->send(session);
+            }
+        }
+    }
+
+    std::cerr << "Stopped serving, " << n_sessions << " session(s) served." << std::endl;
+    return true;
+}
+
+void Server::accept_clients()
+{
+    ScreenLocation size = Game::get_screen_size(n_panels, n_rows, n_columns, attempts_max);
+    for (;;) {
+        int fd = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd == -1) {
+            if ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR)) {
+                std::cerr << "Error: Failed to accept a client: " << std::strerror(errno) << std::endl;
+            }
+            return;
+        }
+        // Start the game of the client, on its own board.
+        unsigned session_seed = seed ? seed + static_cast<unsigned>(n_sessions) : 0;
+        std::unique_ptr<Session> session(new Session(fd, size, dictionary, n_panels, n_rows, n_columns, n_words, attempts_max, session_seed, prefetcher));
+        session->game.set_difficulty(index, difficulty);
+        session->game.set_animated(animated);
+        if (!session->game.initialize()) {
+            ::close(fd);
+            continue;
+        }
+        epoll_event event;
+        event.events  = EPOLLIN;
+        event.data.fd = fd;
+        if (epoll_ctl(poller, EPOLL_CTL_ADD, fd, &event) == -1) {
+            std::cerr << "Error: Failed to poll a client: " << std::strerror(errno) << std::endl;
+            ::close(fd);
+            continue;
+        }
+        ++n_sessions;
+        Session &added = *(sessions[fd] = std::move(session));
+        // Negotiate the character mode, then send the first frame.
+        if (::send(fd, telnet_negotiation, sizeof(telnet_negotiation), MSG_NOSIGNAL) != static_cast<ssize_t>(sizeof(telnet_negotiation))) {
+            this->close(fd);
+            continue;
+        }
+        this->schedule(added);
+        this->send(added);
+    }
+}
+
+void Server::receive(Session &session)
+{
+    unsigned char buffer[512];
+    InputEvent events[512];
+    for (;;) {
+        ssize_t count = ::read(session.fd, buffer, sizeof(buffer));
+        if (count == 0) {
+            this->close(session.fd);
+            return;
+        }
+        if (count == -1) {
+            if ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR)) {
+                this->close(session.fd);
+                return;
+            }
+            break;
+        }
+        // Decode the whole chunk, and render a single frame for all its keys.
+        std::size_t n_events = 0;
+        for (ssize_t i = 0; (i < count) && !session.closing; ++i) {
+            int key = this->decode(session, buffer[i]);
+            if (key == 'q') {
+                session.closing = true;
+            } else if (key != -1) {
+                events[n_events++] = InputEvent{ key, -1, -1 };
+            }
+        }
+        if (n_events > 0) {
+            session.game.handle_input(events, n_events);
+        }
+        if (session.closing) {
+            // Leave the client terminal below the screen.
+            session.target.present(0, session.target.get_height() - 1);
+            session.game.stop();
+            session.target.append_output("\r\n");
+            break;
+        }
+    }
+    if (!session.closing) {
+        this->schedule(session);
+    } else {
+        animating.erase(session.fd);
+    }
+    this->send(session);
+}
+
+void Server::schedule(Session &session)
+{
+    if (!session.game.is_animating() || !animating.insert(session.fd).second) {
+        return;
+    }
+    // Start ticking with the first animating session.
+    if (animating.size() == 1) {
+        arm_timer(ticker, true);
+    }
+}
+
+void Server::tick()
+{
+    // Take the number of ticks elapsed, more than one if the loop was late.
+    uint64_t n_ticks = 0;
+    if ((::read(ticker, &n_ticks, sizeof(n_ticks)) != static_cast<ssize_t>(sizeof(n_ticks))) || (n_ticks == 0)) {
+        return;
+    }
+    for (std::set<int>::iterator it = animating.begin(); it != animating.end();) {
+        // Move on first, since sending may close the session.
+        int fd = *it++;
+        Session &session = *sessions[fd];
+        if (!session.game.tick(static_cast<std::size_t>(n_ticks))) {
+            animating.erase(fd);
+        }
+        this->send(session);
+    }
+    // Stop ticking when nothing animates anymore.
+    if (animating.empty()) {
+        arm_timer(ticker, false);
+    }
+}
+
+void Server::send(Session &session)
+{
+    const std::string &output = session.target.get_output();
+    while (session.sent < output.size()) {
+        ssize_t count = ::send(session.fd, output.data() + session.sent, output.size() - session.sent, MSG_NOSIGNAL);
+        if (count == -1) {
+            if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+                break;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            this->close(session.fd);
+            return;
+        }
+        session.sent += static_cast<std::size_t>(count);
+    }
+
+    if (session.sent == output.size()) {
+        // Everything was sent, reuse the output buffer.
+        session.target.clear_output();
+        session.sent = 0;
+        if (session.closing) {
+            this->close(session.fd);
+            return;
+        }
+    }
+
+    // Poll for writing only while there is output left.
+    bool writable = session.sent != 0;
+    if (writable != session.writable) {
+        epoll_event event;
+        event.events  = writable ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+        event.data.fd = session.fd;
+        epoll_ctl(poller, EPOLL_CTL_MOD, session.fd, &event);
+        session.writable = writable;
+    }
+}
+
+void Server::close(int fd)
+{
+    animating.erase(fd);
+    epoll_ctl(poller, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+    sessions.erase(fd);
+}
+
+#else
+
+Server::~Server()
+{
+    // Nothing to do.
+}
+
+bool Server::serve(uint16_t)
+{
+    std::cerr << "Error: Serving is only supported on Linux." << std::endl;
+    return false;
+}
+
+void Server::accept_clients()
+{
+    // Nothing to do.
+}
+
+void Server::receive(Session &)
+{
+    // Nothing to do.
+}
+
+void Server::send(Session &)
+{
+    // Nothing to do.
+}
+
+void Server::schedule(Session &)
+{
+    // Nothing to do.
+}
+
+void Server::tick()
+{
+    // Nothing to do.
+}
+
+void Server::close(int)
+{
+    // Nothing to do.
+}
+
+#endif
+
+int Server::decode(Session &session, unsigned char byte) const
+{
+    // Strip the telnet commands.
+    switch (session.telnet) {
+    case TelnetCommand:
+        if (byte == TELNET_IAC) {
+            // An escaped 255, which is not a key of the game.
+            session.telnet = TelnetData;
+        } else if (byte == TELNET_SB) {
+            session.telnet = TelnetSubnegotiation;
+        } else if (byte >= TELNET_WILL) {
+            session.telnet = TelnetOption;
+        } else {
+            session.telnet = TelnetData;
+        }
+        return -1;
+    case TelnetOption:
+        session.telnet = TelnetData;
+        return -1;
+    case TelnetSubnegotiation:
+        if (byte == TELNET_IAC) {
+            session.telnet = TelnetSubnegotiationIac;
+        }
+        return -1;
+    case TelnetSubnegotiationIac:
+        session.telnet = (byte == TELNET_SE) ? TelnetData : TelnetSubnegotiation;
+        return -1;
+    default:
+        if (byte == TELNET_IAC) {
+            session.telnet = TelnetCommand;
+            return -1;
+        }
+        break;
+    }
+
+    // Translate the arrow keys, sent either as ESC [ x or ESC O x.
+    if (session.escape == EscapeStart) {
+        session.escape = ((byte == '[') || (byte == 'O')) ? EscapeSequence : EscapeNone;
+        return -1;
+    }
+    if (session.escape == EscapeSequence) {
+        // Skip the parameters, up to the final byte.
+        if ((byte >= 0x30) && (byte <= 0x3f)) {
+            return -1;
+        }
+        session.escape = EscapeNone;
+        switch (byte) {
+        case 'A': return KEY_UP;
+        case 'B': return KEY_DOWN;
+        case 'C': return KEY_RIGHT;
+        case 'D': return KEY_LEFT;
+        default: return -1;
+        }
+    }
+    if (byte == 0x1b) {
+        session.escape = EscapeStart;
+        return -1;
+    }
+
+    // Telnet sends Enter as CR LF or CR NUL, while raw clients send just LF.
+    bool after_carriage_return = session.carriage_return;
+    session.carriage_return    = (byte == '\r');
+    if (byte == '\r') {
+        return 10;
+    }
+    if (((byte == '\n') || (byte == '\0')) && after_carriage_return) {
+        return -1;
+    }
+    if (byte == '\n') {
+        return 10;
+    }
+    return byte;
+}
+
+} // namespace robsec
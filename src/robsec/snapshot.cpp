@@ -0,0 +1,295 @@
+/// @file snapshot.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Implementation of the board snapshots.
+
+#include "robsec/snapshot.hpp"
+#include "robsec/varint.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+/// @brief Magic bytes at the beginning of a snapshot.
+#define SNAPSHOT_MAGIC "ROBSSNAP"
+
+/// @brief Version of the snapshot format.
+#define SNAPSHOT_VERSION 1
+
+/// @brief Number of bits of a cell of the content.
+#define SYMBOL_BITS 5
+
+/// @brief Value of the characters which are not in the garbage alphabet.
+#define NO_SYMBOL 0xFF
+
+/// @brief Maps the characters to their index in the garbage alphabet, and back.
+struct GarbageAlphabet {
+    uint8_t symbols[256];               ///< Index of each character, NO_SYMBOL if it is not garbage.
+    char characters[1U << SYMBOL_BITS]; ///< Character of each index.
+    std::size_t n_symbols;              ///< Number of distinct characters.
+
+    GarbageAlphabet()
+        : n_symbols(0)
+    {
+        std::memset(symbols, NO_SYMBOL, sizeof(symbols));
+        // The characters beyond the bits of a cell are left out, and refused.
+        for (const char *c = robsec::Board::garbage; *c && (n_symbols < (1U << SYMBOL_BITS)); ++c) {
+            uint8_t &symbol = symbols[static_cast<uint8_t>(*c)];
+            if (symbol == NO_SYMBOL) {
+                symbol                  = static_cast<uint8_t>(n_symbols);
+                characters[n_symbols++] = *c;
+            }
+        }
+    }
+};
+
+/// @brief Returns the garbage alphabet, built once.
+static inline const GarbageAlphabet &get_alphabet()
+{
+    static const GarbageAlphabet alphabet;
+    return alphabet;
+}
+
+/// @brief Reads a variable-length integer which must not exceed a limit.
+/// @return true on success, false if the data ends or the value exceeds the limit.
+static inline bool read_bounded(const char *data, std::size_t size, std::size_t &offset, uint64_t limit, std::size_t &value)
+{
+    uint64_t raw;
+    if (!robsec::read_varint(data, size, offset, raw) || (raw > limit)) {
+        return false;
+    }
+    value = static_cast<std::size_t>(raw);
+    return true;
+}
+
+namespace robsec
+{
+
+bool serialize_board(const Dictionary &dictionary, const Board &board, std::vector<char> &buffer)
+{
+    const std::vector<DictionaryGroup> &groups = dictionary.get_groups();
+    if (!board.group || groups.empty() || (board.group < groups.data()) || (board.group >= groups.data() + groups.size())) {
+        std::cerr << "Error: The board does not come from the dictionary." << std::endl;
+        return false;
+    }
+    const GarbageAlphabet &alphabet = get_alphabet();
+
+    // Header, with room for the whole snapshot.
+    buffer.reserve(buffer.size() + 64 + 16 * board.get_n_words() + (board.content.size() * SYMBOL_BITS + 7) / 8);
+    buffer.insert(buffer.end(), SNAPSHOT_MAGIC, SNAPSHOT_MAGIC + 8);
+    write_varint(buffer, SNAPSHOT_VERSION);
+
+    // Layout, and the group the words belong to, with its size to catch a
+    // different dictionary.
+    write_varint(buffer, board.n_panels);
+    write_varint(buffer, board.n_rows);
+    write_varint(buffer, board.n_columns);
+    write_varint(buffer, static_cast<uint64_t>(board.group - groups.data()));
+    write_varint(buffer, board.group->length);
+    write_varint(buffer, board.group->size());
+
+    // Words and solution.
+    write_varint(buffer, board.get_n_words());
+    for (std::size_t i = 0; i < board.get_n_words(); ++i) {
+        write_varint(buffer, board.word_ids[i]);
+        write_varint(buffer, board.word_panels[i]);
+        write_varint(buffer, board.word_starts[i]);
+    }
+    write_varint(buffer, board.solution_index);
+    write_varint(buffer, board.start_address);
+
+    // Content, packed against the garbage alphabet, lowest bits first.
+    uint32_t bits = 0;
+    unsigned used = 0;
+    for (std::size_t i = 0; i < board.content.size(); ++i) {
+        uint8_t symbol = alphabet.symbols[static_cast<uint8_t>(board.content[i])];
+        if (symbol == NO_SYMBOL) {
+            std::cerr << "Error: The board has a character out of the garbage alphabet at cell " << i << "." << std::endl;
+            return false;
+        }
+        bits |= static_cast<uint32_t>(symbol) << used;
+        for (used += SYMBOL_BITS; used >= 8; used -= 8, bits >>= 8) {
+            buffer.push_back(static_cast<char>(bits & 0xFF));
+        }
+    }
+    if (used > 0) {
+        buffer.push_back(static_cast<char>(bits & 0xFF));
+    }
+
+    // Removed words, in order.
+    std::size_t n_removed = 0;
+    for (std::size_t i = 0; i < board.get_n_words(); ++i) {
+        n_removed += board.is_removed(i) ? 1 : 0;
+    }
+    write_varint(buffer, n_removed);
+    for (std::size_t i = 0; i < board.get_n_words(); ++i) {
+        if (board.is_removed(i)) {
+            write_varint(buffer, i);
+        }
+    }
+
+    // Bracket pairs still usable, as the distance from the previous one.
+    std::size_t n_pairs = 0;
+    for (std::size_t i = 0; i < board.pairs.size(); ++i) {
+        n_pairs += board.pairs[i] ? 1 : 0;
+    }
+    write_varint(buffer, n_pairs);
+    for (std::size_t i = 0, previous = 0; i < board.pairs.size(); ++i) {
+        if (board.pairs[i]) {
+            write_varint(buffer, i - previous);
+            previous = i;
+        }
+    }
+    return true;
+}
+
+bool deserialize_board(const Dictionary &dictionary, const char *data, std::size_t size, std::size_t &offset, Board &board)
+{
+    const std::vector<DictionaryGroup> &groups = dictionary.get_groups();
+    const GarbageAlphabet &alphabet            = get_alphabet();
+
+    // Header.
+    uint64_t version;
+    if ((size - std::min(offset, size) < 8) || (std::memcmp(data + offset, SNAPSHOT_MAGIC, 8) != 0)) {
+        std::cerr << "Error: Not a snapshot." << std::endl;
+        return false;
+    }
+    offset += 8;
+    if (!read_varint(data, size, offset, version) || (version != SNAPSHOT_VERSION)) {
+        std::cerr << "Error: Unsupported snapshot version." << std::endl;
+        return false;
+    }
+
+    // Layout and group. The sizes are bounded, so that a corrupted snapshot
+    // cannot ask for a huge board.
+    std::size_t n_panels, n_rows, n_columns, group_index, length, group_size;
+    if (!read_bounded(data, size, offset, 0xFFFF, n_panels) || !read_bounded(data, size, offset, 0xFFFF, n_rows) ||
+        !read_bounded(data, size, offset, 0xFFFF, n_columns) || !read_bounded(data, size, offset, UINT32_MAX, group_index) ||
+        !read_bounded(data, size, offset, UINT32_MAX, length) || !read_bounded(data, size, offset, UINT32_MAX, group_size)) {
+        std::cerr << "Error: The snapshot is corrupted." << std::endl;
+        return false;
+    }
+    std::size_t n_cells = n_panels * n_rows * n_columns;
+    if ((n_cells == 0) || (n_cells > (1U << 24))) {
+        std::cerr << "Error: The snapshot has an invalid layout." << std::endl;
+        return false;
+    }
+    if ((group_index >= groups.size()) || (groups[group_index].length != length) || (groups[group_index].size() != group_size)) {
+        std::cerr << "Error: The snapshot was saved with a different dictionary." << std::endl;
+        return false;
+    }
+    if ((length == 0) || (length > n_rows * n_columns) || (group_size == 0)) {
+        std::cerr << "Error: The snapshot has words which do not fit the panels." << std::endl;
+        return false;
+    }
+
+    // Start from an empty board.
+    board.clear();
+    board.n_panels  = n_panels;
+    board.n_rows    = n_rows;
+    board.n_columns = n_columns;
+    board.group     = &groups[group_index];
+
+    // Words and solution, each one inside its panel.
+    std::size_t n_words;
+    if (!read_bounded(data, size, offset, n_cells, n_words) || (n_words == 0)) {
+        std::cerr << "Error: The snapshot has no words." << std::endl;
+        return false;
+    }
+    board.word_ids.reserve(n_words);
+    board.word_panels.reserve(n_words);
+    board.word_starts.reserve(n_words);
+    for (std::size_t i = 0; i < n_words; ++i) {
+        std::size_t id, panel, start;
+        if (!read_bounded(data, size, offset, group_size - 1, id) || !read_bounded(data, size, offset, n_panels - 1, panel) ||
+            !read_bounded(data, size, offset, n_rows * n_columns - length, start)) {
+            std::cerr << "Error: The snapshot has an invalid word." << std::endl;
+            return false;
+        }
+        board.word_ids.push_back(static_cast<uint32_t>(id));
+        board.word_panels.push_back(static_cast<uint32_t>(panel));
+        board.word_starts.push_back(static_cast<uint32_t>(start));
+    }
+    if (!read_bounded(data, size, offset, n_words - 1, board.solution_index) || !read_bounded(data, size, offset, 0xFFFF, board.start_address)) {
+        std::cerr << "Error: The snapshot is corrupted." << std::endl;
+        return false;
+    }
+
+    // Content.
+    std::size_t n_bytes = (n_cells * SYMBOL_BITS + 7) / 8;
+    if (size - offset < n_bytes) {
+        std::cerr << "Error: The snapshot is truncated." << std::endl;
+        return false;
+    }
+    board.content.resize(n_cells);
+    const uint8_t *packed = reinterpret_cast<const uint8_t *>(data + offset);
+    uint32_t bits         = 0;
+    unsigned available    = 0;
+    for (std::size_t i = 0; i < n_cells; ++i) {
+        if (available < SYMBOL_BITS) {
+            bits |= static_cast<uint32_t>(*packed++) << available;
+            available += 8;
+        }
+        std::size_t symbol = bits & ((1U << SYMBOL_BITS) - 1);
+        if (symbol >= alphabet.n_symbols) {
+            std::cerr << "Error: The snapshot has an invalid cell." << std::endl;
+            return false;
+        }
+        board.content[i] = alphabet.characters[symbol];
+        bits >>= SYMBOL_BITS;
+        available -= SYMBOL_BITS;
+    }
+    offset += n_bytes;
+
+    // Rebuild the tables, with all the words on the board and all the pairs.
+    board.index_words();
+    board.index_brackets();
+    board.likeness.build(*board.group, board.word_ids.data(), board.get_n_words());
+
+    // Read the removed words, which are removed once the pairs are known.
+    std::size_t n_removed;
+    ArenaVector<uint32_t> removed(ArenaAllocator<uint32_t>(*board.arena));
+    if (!read_bounded(data, size, offset, n_words, n_removed)) {
+        std::cerr << "Error: The snapshot is corrupted." << std::endl;
+        return false;
+    }
+    removed.reserve(n_removed);
+    for (std::size_t i = 0; i < n_removed; ++i) {
+        std::size_t index;
+        if (!read_bounded(data, size, offset, n_words - 1, index) || (index == board.solution_index)) {
+            std::cerr << "Error: The snapshot has an invalid removed word." << std::endl;
+            return false;
+        }
+        removed.push_back(static_cast<uint32_t>(index));
+    }
+
+    // Keep only the pairs still usable.
+    std::size_t n_pairs;
+    if (!read_bounded(data, size, offset, n_cells, n_pairs)) {
+        std::cerr << "Error: The snapshot is corrupted." << std::endl;
+        return false;
+    }
+    std::size_t kept = 0;
+    for (std::size_t i = 0, cell = 0; i < n_pairs; ++i) {
+        std::size_t delta;
+        if (!read_bounded(data, size, offset, n_cells - 1 - cell, delta) || !board.pairs[cell + delta]) {
+            std::cerr << "Error: The snapshot has an invalid bracket pair." << std::endl;
+            return false;
+        }
+        cell += delta;
+        // Clear the consumed pairs before this one.
+        for (; kept < cell; ++kept) {
+            board.pairs[kept] = 0;
+        }
+        kept = cell + 1;
+    }
+    for (; kept < n_cells; ++kept) {
+        board.pairs[kept] = 0;
+    }
+
+    for (uint32_t index : removed) {
+        board.remove_word(index);
+    }
+    return true;
+}
+
+} // namespace robsec
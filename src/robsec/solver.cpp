@@ -0,0 +1,145 @@
+/// @file solver.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Implementation of the solver.
+
+#include "robsec/solver.hpp"
+
+#include <algorithm>
+
+/// @brief Returns the index of the lowest set bit.
+static inline std::size_t lowest_set_bit(uint64_t bits)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<std::size_t>(__builtin_ctzll(bits));
+#else
+    std::size_t index = 0;
+    for (; !(bits & 1U); bits >>= 1) {
+        ++index;
+    }
+    return index;
+#endif
+}
+
+/// @brief Calls the given function with the index of each set bit.
+///
+/// @tparam Function Type of the function.
+/// @param bits The bitset.
+/// @param fun The function to call.
+template <typename Function>
+static inline void for_each_set_bit(const std::vector<uint64_t> &bits, Function fun)
+{
+    for (std::size_t block = 0; block < bits.size(); ++block) {
+        for (uint64_t word = bits[block]; word; word &= word - 1) {
+            fun(block * 64 + lowest_set_bit(word));
+        }
+    }
+}
+
+namespace robsec
+{
+
+Solver::Solver()
+    : likeness(nullptr),
+      candidates(),
+      guesses(),
+      remaining(0),
+      buckets()
+{
+    // Nothing to do.
+}
+
+void Solver::reset(const LikenessMatrix &_likeness)
+{
+    likeness  = &_likeness;
+    remaining = likeness->get_size();
+    candidates.assign((remaining + 63) / 64, 0);
+    for (std::size_t i = 0; i < remaining; ++i) {
+        candidates[i / 64] |= uint64_t(1) << (i % 64);
+    }
+    guesses = candidates;
+}
+
+void Solver::observe(std::size_t guess, int common_letters)
+{
+    if (!likeness || (guess >= likeness->get_size())) {
+        return;
+    }
+    // Keep only the words sharing exactly that many letters with the guess.
+    const uint8_t *row = likeness->row(guess);
+    for_each_set_bit(candidates, [this, row, common_letters](std::size_t word) {
+        if (row[word] != common_letters) {
+            candidates[word / 64] &= ~(uint64_t(1) << (word % 64));
+            --remaining;
+        }
+    });
+    // The guess was wrong, so it is not the solution either.
+    if (this->is_candidate(guess)) {
+        candidates[guess / 64] &= ~(uint64_t(1) << (guess % 64));
+        --remaining;
+    }
+}
+
+void Solver::remove(std::size_t word)
+{
+    if (!likeness || (word >= likeness->get_size())) {
+        return;
+    }
+    if (this->is_candidate(word)) {
+        candidates[word / 64] &= ~(uint64_t(1) << (word % 64));
+        --remaining;
+    }
+    guesses[word / 64] &= ~(uint64_t(1) << (word % 64));
+}
+
+bool Solver::is_candidate(std::size_t word) const
+{
+    return (word / 64 < candidates.size()) && ((candidates[word / 64] >> (word % 64)) & 1U);
+}
+
+std::size_t Solver::get_remaining() const
+{
+    return remaining;
+}
+
+std::size_t Solver::best_guess() const
+{
+    if (!likeness || (likeness->get_size() == 0)) {
+        return 0;
+    }
+    std::size_t best = 0, best_worst = SIZE_MAX, best_squares = SIZE_MAX;
+    bool best_candidate = false;
+    for (std::size_t guess = 0; guess < likeness->get_size(); ++guess) {
+        // Skip the removed words.
+        if (!((guesses[guess / 64] >> (guess % 64)) & 1U)) {
+            continue;
+        }
+        // Split the candidates by the feedback the guess would receive.
+        const uint8_t *row = likeness->row(guess);
+        // The likeness never exceeds the one of the guess with itself.
+        buckets.assign(static_cast<std::size_t>(row[guess]) + 1, 0);
+        for_each_set_bit(candidates, [this, row, guess](std::size_t word) {
+            // Guessing the solution wins, so it leaves nothing to split.
+            if (word != guess) {
+                ++buckets[row[word]];
+            }
+        });
+        std::size_t worst = 0, squares = 0;
+        for (std::size_t count : buckets) {
+            worst = std::max(worst, count);
+            squares += count * count;
+        }
+        bool candidate = this->is_candidate(guess);
+        // Minimize the worst case, then prefer candidates, then minimize the expected case.
+        if ((worst < best_worst) ||
+            ((worst == best_worst) && (candidate && !best_candidate)) ||
+            ((worst == best_worst) && (candidate == best_candidate) && (squares < best_squares))) {
+            best           = guess;
+            best_worst     = worst;
+            best_squares   = squares;
+            best_candidate = candidate;
+        }
+    }
+    return best;
+}
+
+} // namespace robsec
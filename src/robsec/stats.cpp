@@ -0,0 +1,162 @@
+/// @file stats.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Implementation of the game statistics.
+
+#include "robsec/stats.hpp"
+#include "robsec/allocation_counter.hpp"
+
+#include <cmath>
+#include <cstring>
+
+/// @brief Returns the index of the most significant bit set (the value must not be zero).
+static inline unsigned most_significant_bit(uint64_t value)
+{
+    unsigned bit = 0;
+    while (value >>= 1) {
+        ++bit;
+    }
+    return bit;
+}
+
+/// @brief Writes a row of the text report: count, mean, p50, p99 and max.
+static void write_text_row(std::ostream &out, const char *name, const robsec::Histogram &histogram, double scale, const char *unit)
+{
+    out << "  " << name << ": n=" << histogram.get_count()
+        << " mean=" << histogram.get_mean() / scale << unit
+        << " p50=" << static_cast<double>(histogram.get_percentile(0.50)) / scale << unit
+        << " p99=" << static_cast<double>(histogram.get_percentile(0.99)) / scale << unit
+        << " max=" << static_cast<double>(histogram.get_max()) / scale << unit << "\n";
+}
+
+/// @brief Writes a histogram as a JSON object.
+static void write_json_histogram(std::ostream &out, const char *name, const robsec::Histogram &histogram)
+{
+    out << "\"" << name << "\":{\"count\":" << histogram.get_count()
+        << ",\"mean\":" << histogram.get_mean()
+        << ",\"p50\":" << histogram.get_percentile(0.50)
+        << ",\"p99\":" << histogram.get_percentile(0.99)
+        << ",\"max\":" << histogram.get_max() << "}";
+}
+
+namespace robsec
+{
+
+Histogram::Histogram()
+    : count(0),
+      max(0),
+      sum(0)
+{
+    std::memset(counts, 0, sizeof(counts));
+}
+
+void Histogram::record(uint64_t value)
+{
+    std::size_t index;
+    if (value < 16) {
+        index = static_cast<std::size_t>(value);
+    } else {
+        // The three bits after the most significant one select the bucket.
+        unsigned bit = most_significant_bit(value);
+        index        = 16 + (bit - 4) * 8 + static_cast<std::size_t>((value >> (bit - 3)) & 7);
+    }
+    ++counts[index];
+    ++count;
+    sum += value;
+    max = (value > max) ? value : max;
+}
+
+uint64_t Histogram::get_count() const
+{
+    return count;
+}
+
+uint64_t Histogram::get_max() const
+{
+    return max;
+}
+
+double Histogram::get_mean() const
+{
+    return count ? static_cast<double>(sum) / static_cast<double>(count) : 0.0;
+}
+
+uint64_t Histogram::get_percentile(double fraction) const
+{
+    if (count == 0) {
+        return 0;
+    }
+    uint64_t rank = static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(count)));
+    rank          = (rank == 0) ? 1 : rank;
+    uint64_t seen = 0;
+    for (std::size_t index = 0; index < n_buckets; ++index) {
+        seen += counts[index];
+        if (seen >= rank) {
+            if (index < 16) {
+                return index;
+            }
+            // Report the upper bound of the bucket, but never above the maximum.
+            unsigned bit   = static_cast<unsigned>(4 + (index - 16) / 8);
+            uint64_t upper = ((8 + (index - 16) % 8 + 1) << (bit - 3)) - 1;
+            return (upper < max) ? upper : max;
+        }
+    }
+    return max;
+}
+
+GameStats::GameStats()
+    : dictionary_load(0),
+      index_build(0),
+      generation{ 0, 0, 0 },
+      target_start(0),
+      first_frame(0),
+      input_latency(),
+      render_time(),
+      present_time(),
+      frame_allocations()
+{
+    // Nothing to do.
+}
+
+void GameStats::write_text(std::ostream &out) const
+{
+    out << "Initialization:\n"
+        << "  dictionary load: " << dictionary_load * 1e3 << " ms\n"
+        << "  likeness index: " << index_build * 1e3 << " ms\n"
+        << "  word placement: " << generation.placement * 1e3 << " ms\n"
+        << "  garbage fill: " << generation.garbage * 1e3 << " ms\n"
+        << "  likeness matrix: " << generation.likeness * 1e3 << " ms\n"
+        << "  target start: " << target_start * 1e3 << " ms\n"
+        << "  first frame: " << first_frame * 1e3 << " ms\n"
+        << "Frames:\n";
+    write_text_row(out, "input to paint", input_latency, 1e3, " us");
+    write_text_row(out, "render", render_time, 1e3, " us");
+    write_text_row(out, "present", present_time, 1e3, " us");
+    if (counting_allocations()) {
+        write_text_row(out, "allocations", frame_allocations, 1, "");
+    }
+}
+
+void GameStats::write_json(std::ostream &out) const
+{
+    out << "{\"initialization\":{"
+        << "\"dictionary_load_s\":" << dictionary_load
+        << ",\"index_build_s\":" << index_build
+        << ",\"placement_s\":" << generation.placement
+        << ",\"garbage_s\":" << generation.garbage
+        << ",\"likeness_s\":" << generation.likeness
+        << ",\"target_start_s\":" << target_start
+        << ",\"first_frame_s\":" << first_frame << "},\"frames_ns\":{";
+    write_json_histogram(out, "input_to_paint", input_latency);
+    out << ",";
+    write_json_histogram(out, "render", render_time);
+    out << ",";
+    write_json_histogram(out, "present", present_time);
+    out << "}";
+    if (counting_allocations()) {
+        out << ",";
+        write_json_histogram(out, "frame_allocations", frame_allocations);
+    }
+    out << "}\n";
+}
+
+} // namespace robsec
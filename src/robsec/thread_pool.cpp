@@ -0,0 +1,125 @@
+/// @file thread_pool.cpp
+/// @author Enrico Fraccaroli (enry.frak@gmail.com)
+/// @brief Implementation of the work-stealing pool of threads.
+
+#include "robsec/thread_pool.hpp"
+
+#include <algorithm>
+
+namespace robsec
+{
+
+ThreadPool::ThreadPool(std::size_t n_threads)
+    : queues(),
+      workers(),
+      mutex(),
+      work_available(),
+      work_done(),
+      queued(0),
+      pending(0),
+      next(0),
+      stopping(false)
+{
+    if (n_threads == 0) {
+        n_threads = std::max(1U, std::thread::hardware_concurrency());
+    }
+    for (std::size_t i = 0; i < n_threads; ++i) {
+        queues.emplace_back(new Queue());
+    }
+    for (std::size_t i = 0; i < n_threads; ++i) {
+        workers.emplace_back(&ThreadPool::work, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    this->wait();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    work_available.notify_all();
+    for (auto &worker : workers) {
+        worker.join();
+    }
+}
+
+std::size_t ThreadPool::get_size() const
+{
+    return workers.size();
+}
+
+void ThreadPool::submit(Task task)
+{
+    pending.fetch_add(1);
+    {
+        // Counted under the lock, so that a worker going to sleep cannot miss
+        // it, and before the push, so that the counter never goes below zero.
+        std::lock_guard<std::mutex> lock(mutex);
+        queued.fetch_add(1);
+    }
+    Queue &queue = *queues[next.fetch_add(1) % queues.size()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+    work_available.notify_one();
+}
+
+void ThreadPool::wait()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    work_done.wait(lock, [this] { return pending.load() == 0; });
+}
+
+void ThreadPool::work(std::size_t index)
+{
+    Task task;
+    while (true) {
+        if (this->pop(index, task) || this->steal(index, task)) {
+            task();
+            task = nullptr;
+            if (pending.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lock(mutex);
+                work_done.notify_all();
+            }
+            continue;
+        }
+        // Nothing to do, sleep until a task is submitted.
+        std::unique_lock<std::mutex> lock(mutex);
+        work_available.wait(lock, [this] { return stopping || (queued.load() > 0); });
+        if (stopping && (queued.load() == 0)) {
+            return;
+        }
+    }
+}
+
+bool ThreadPool::pop(std::size_t index, Task &task)
+{
+    Queue &queue = *queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    queued.fetch_sub(1);
+    return true;
+}
+
+bool ThreadPool::steal(std::size_t index, Task &task)
+{
+    for (std::size_t offset = 1; offset < queues.size(); ++offset) {
+        Queue &queue = *queues[(index + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            queued.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace robsec
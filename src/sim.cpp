@@ -0,0 +1,212 @@
+#include "robsec/board.hpp"
+#include "robsec/dictionary.hpp"
+#include "robsec/likeness_index.hpp"
+#include "robsec/solver.hpp"
+#include "robsec/thread_pool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+#include <cmdlp/parser.hpp>
+
+/// @brief Number of games played by each task.
+#define GAMES_PER_TASK 1024
+
+/// @brief Results of the simulated games with a given word length.
+struct Statistics {
+    std::size_t games;   ///< Number of games played.
+    std::size_t wins;    ///< Number of games won.
+    std::size_t guesses; ///< Number of guesses made.
+    std::size_t failed;  ///< Number of boards that could not be generated.
+};
+
+/// @brief A combination of attempts and words to simulate.
+struct Setting {
+    int attempts;                               ///< The number of attempts.
+    std::size_t words;                          ///< The number of words.
+    std::map<std::size_t, Statistics> results; ///< The results, by word length.
+};
+
+/// @brief Parses a comma-separated list of positive numbers.
+///
+/// @param list The list to parse.
+/// @return The numbers in the list.
+static std::vector<std::size_t> parse_list(const std::string &list)
+{
+    std::vector<std::size_t> values;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        std::size_t value = std::strtoul(item.c_str(), nullptr, 10);
+        if (value > 0) {
+            values.push_back(value);
+        }
+    }
+    return values;
+}
+
+/// @brief Plays the given number of games, with the solver choosing every guess.
+///
+/// @param generator The generator of the boards.
+/// @param attempts The number of attempts of each game.
+/// @param n_games The number of games to play.
+/// @param engine The random engine of the task.
+/// @param results Where the results, by word length, are accumulated.
+static void simulate(const robsec::BoardGenerator &generator,
+                     int attempts,
+                     std::size_t n_games,
+                     robsec::RandomEngine &engine,
+                     std::map<std::size_t, Statistics> &results)
+{
+    robsec::Board board;
+    robsec::Solver solver;
+    for (std::size_t game = 0; game < n_games; ++game) {
+        if (!generator.generate(board, engine)) {
+            ++results[0].failed;
+            continue;
+        }
+        Statistics &statistics = results[board.get_word_length()];
+        ++statistics.games;
+        solver.reset(board.likeness);
+        for (int left = attempts; left > 0; --left) {
+            std::size_t guess = solver.best_guess();
+            ++statistics.guesses;
+            if (guess == board.solution_index) {
+                ++statistics.wins;
+                break;
+            }
+            solver.observe(guess, board.likeness.at(guess, board.solution_index));
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    cmdlp::Parser parser(argc, argv);
+    parser.addOption("-d", "--dictionary", "The comma-separated paths to the dictionary files or directories.", "", true);
+    parser.addToggle("-u", "--unique", "Keeps only once the words repeated in the dictionaries.", false);
+    parser.addOption("-D", "--difficulty", "The difficulty of the boards: 'easy', 'medium' or 'hard' (default: random words).", "", false);
+    parser.addOption("-p", "--pannels", "The number of pannels.", 3, false);
+    parser.addOption("-r", "--rows", "The number of rows.", 20, false);
+    parser.addOption("-c", "--columns", "The number of columns.", 12, false);
+    parser.addOption("-w", "--words", "Comma-separated list of numbers of words.", "12", false);
+    parser.addOption("-a", "--attemps", "Comma-separated list of numbers of attemps.", "4", false);
+    parser.addOption("-g", "--games", "The number of games for each setting.", 100000, false);
+    parser.addOption("-t", "--threads", "The number of threads (0 for one per core).", 0, false);
+    parser.addOption("-s", "--seed", "The seed of the simulation (0 for a random one).", 0, false);
+    parser.parseOptions();
+
+    std::size_t n_panels  = parser.getOption<unsigned>("-p");
+    std::size_t n_rows    = parser.getOption<unsigned>("-r");
+    std::size_t n_columns = parser.getOption<unsigned>("-c");
+    std::size_t n_games   = parser.getOption<unsigned>("-g");
+    unsigned seed         = robsec::resolve_seed(parser.getOption<unsigned>("-s"));
+
+    // Check the difficulty.
+    robsec::Difficulty difficulty = robsec::Unrated;
+    if (!parser.getOption<std::string>("-D").empty() && !robsec::parse_difficulty(parser.getOption<std::string>("-D"), difficulty)) {
+        std::cerr << "Error: The difficulty must be 'easy', 'medium' or 'hard': " << parser.getOption<std::string>("-D") << std::endl;
+        return 1;
+    }
+
+    // Load the dictionary, shared read-only by all the workers.
+    std::vector<std::string> files;
+    robsec::Dictionary dictionary;
+    if (!robsec::Dictionary::list_files(parser.getOption<std::string>("-d"), files) ||
+        !dictionary.load(files, parser.getOption<unsigned>("-t"), parser.getOption<bool>("-u"))) {
+        std::cerr << "Error: Failed to load the dictionary." << std::endl;
+        return 1;
+    }
+
+    // Prepare every combination of attempts and words.
+    std::vector<Setting> settings;
+    for (std::size_t attempts : parse_list(parser.getOption<std::string>("-a"))) {
+        for (std::size_t words : parse_list(parser.getOption<std::string>("-w"))) {
+            settings.push_back(Setting{ static_cast<int>(attempts), words, {} });
+        }
+    }
+    if (settings.empty() || (n_games == 0)) {
+        std::cerr << "Error: Nothing to simulate." << std::endl;
+        return 1;
+    }
+
+    // Index the likeness of the words, for the largest boards, if the difficulty is rated.
+    robsec::LikenessIndex index;
+    if (difficulty != robsec::Unrated) {
+        std::size_t max_words = 0;
+        for (const auto &setting : settings) {
+            max_words = std::max(max_words, setting.words);
+        }
+        index.build(dictionary, robsec::LikenessIndex::neighbors_per_board_word * max_words);
+    }
+
+    // Split each setting in tasks, each one with its own random stream
+    // derived from the seed, the setting and the task. The results do not
+    // depend on which worker runs which task.
+    std::size_t n_tasks = (n_games + GAMES_PER_TASK - 1) / GAMES_PER_TASK;
+    std::vector<robsec::BoardGenerator> generators;
+    generators.reserve(settings.size());
+    for (const auto &setting : settings) {
+        generators.emplace_back(dictionary, n_panels, n_rows, n_columns, setting.words);
+        generators.back().set_difficulty(&index, difficulty);
+    }
+    std::vector<std::map<std::size_t, Statistics>> partials(settings.size() * n_tasks);
+
+    auto begin = std::chrono::steady_clock::now();
+    std::size_t n_threads;
+    {
+        robsec::ThreadPool pool(parser.getOption<unsigned>("-t"));
+        n_threads = pool.get_size();
+        for (std::size_t s = 0; s < settings.size(); ++s) {
+            for (std::size_t t = 0; t < n_tasks; ++t) {
+                std::size_t games = std::min<std::size_t>(GAMES_PER_TASK, n_games - t * GAMES_PER_TASK);
+                pool.submit([&, s, t, games]() {
+                    std::seed_seq sequence{ seed, static_cast<unsigned>(s), static_cast<unsigned>(t) };
+                    robsec::RandomEngine engine(sequence);
+                    simulate(generators[s], settings[s].attempts, games, engine, partials[s * n_tasks + t]);
+                });
+            }
+        }
+        pool.wait();
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    // Merge the results of the tasks.
+    std::size_t total_games = 0;
+    for (std::size_t s = 0; s < settings.size(); ++s) {
+        for (std::size_t t = 0; t < n_tasks; ++t) {
+            for (const auto &entry : partials[s * n_tasks + t]) {
+                Statistics &statistics = settings[s].results[entry.first];
+                statistics.games += entry.second.games;
+                statistics.wins += entry.second.wins;
+                statistics.guesses += entry.second.guesses;
+                statistics.failed += entry.second.failed;
+                total_games += entry.second.games;
+            }
+        }
+    }
+
+    // Report the results.
+    std::printf("seed %u, %zu threads, %zux%zux%zu layout\n", seed, n_threads, n_panels, n_rows, n_columns);
+    std::printf("%8s %6s %6s %10s %10s %8s\n", "attempts", "words", "length", "games", "win rate", "guesses");
+    for (const auto &setting : settings) {
+        for (const auto &entry : setting.results) {
+            const Statistics &statistics = entry.second;
+            if (entry.first == 0) {
+                std::printf("%8d %6zu %6s %10zu boards could not be generated\n", setting.attempts, setting.words, "-", statistics.failed);
+                continue;
+            }
+            std::printf("%8d %6zu %6zu %10zu %9.2f%% %8.3f\n",
+                        setting.attempts, setting.words, entry.first, statistics.games,
+                        100.0 * static_cast<double>(statistics.wins) / static_cast<double>(statistics.games),
+                        static_cast<double>(statistics.guesses) / static_cast<double>(statistics.games));
+        }
+    }
+    std::printf("%zu games in %.3f s (%.0f games/s)\n", total_games, elapsed, elapsed > 0 ? static_cast<double>(total_games) / elapsed : 0.0);
+    return 0;
+}